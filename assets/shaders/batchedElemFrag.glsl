@@ -1,14 +1,18 @@
 #version 440 core
 
-uniform vec4 uColor = vec4(0.3, 0.1, 0.4, 1.0);
-uniform vec4 uBorderColor = vec4(0.0, 0.0, 1.0, 1.0);
-uniform vec4 uBorderSize = vec4(0);
-uniform vec4 uBorderRadii = vec4(0);
-uniform vec2 uResolution;
-uniform int uUseTexture = 0;
 uniform sampler2D uTexture;
 
 in vec2 vTexCoords;
+in vec2 vAtlasCoords;
+in vec2 vWorldPos;
+flat in vec4 vColor;
+flat in vec4 vBorderSize;
+flat in vec4 vBorderRadii;
+flat in vec4 vBorderColor;
+flat in vec4 vClipRect;
+flat in vec2 vResolution;
+flat in float vTextureLayer;
+
 out vec4 fragColor;
 
 /**
@@ -27,25 +31,31 @@ float roundedBoxSDF(vec2 uv, vec2 halfSize, vec4 radii)
 
 void main()
 {
+    /* Replaces the per element glScissor. Anything outside of the visible area of the element is cut. */
+    if (any(lessThan(vWorldPos, vClipRect.xy)) || any(greaterThanEqual(vWorldPos, vClipRect.xy + vClipRect.zw)))
+    {
+        discard;
+    }
+
     vec2 p = vTexCoords;
-    p.x *= uResolution.x;
-    p.y *= uResolution.y;
-    p -= vec2(uResolution.x / 2.0, uResolution.y / 2.0);
+    p.x *= vResolution.x;
+    p.y *= vResolution.y;
+    p -= vec2(vResolution.x / 2.0, vResolution.y / 2.0);
 
     /* Wanted size of the outside box. */
-    vec2 outerBoxSize = vec2(uResolution.x, uResolution.y);
+    vec2 outerBoxSize = vec2(vResolution.x, vResolution.y);
 
     /* Size of the content after the borders are in place. */
-    vec2 contentSize = vec2(uResolution.x, uResolution.y);
-    contentSize -= vec2(uBorderSize.z + uBorderSize.w, uBorderSize.x + uBorderSize.y);
+    vec2 contentSize = vec2(vResolution.x, vResolution.y);
+    contentSize -= vec2(vBorderSize.z + vBorderSize.w, vBorderSize.x + vBorderSize.y);
 
     /* Center of the inner box aka the box formed after applying the border sizes for the outer box.*/
     vec2 innerBoxCenter = vec2(
-        ((uBorderSize.z + uBorderSize.w) * 0.5) - uBorderSize.w - 0,
-        ((uBorderSize.x + uBorderSize.y) * 0.5) - uBorderSize.y);
+        ((vBorderSize.z + vBorderSize.w) * 0.5) - vBorderSize.w - 0,
+        ((vBorderSize.x + vBorderSize.y) * 0.5) - vBorderSize.y);
 
     /* Invert inner border radius..for some reason. */
-    vec4 innerBorderRadius = uBorderRadii;
+    vec4 innerBorderRadius = vBorderRadii;
     float temp = innerBorderRadius.z;
     innerBorderRadius.z = innerBorderRadius.x;
     innerBorderRadius.x = temp;
@@ -54,7 +64,7 @@ void main()
     innerBorderRadius.w = innerBorderRadius.y;
     innerBorderRadius.y = temp;
 
-    float outerBoxDist = roundedBoxSDF(p, (outerBoxSize / 2.0), uBorderRadii);
+    float outerBoxDist = roundedBoxSDF(p, (outerBoxSize / 2.0), vBorderRadii);
     float innerBoxDist = roundedBoxSDF((innerBoxCenter) - p, (contentSize / 2.0), innerBorderRadius / 2.0f);
 
     float outerBoxSdf = step(0.0001, outerBoxDist);
@@ -63,13 +73,13 @@ void main()
 
     if (outerBoxSdf >= 1) { discard; }
 
-    /* Set the color of the inner content */
-    vec4 finalColor = uUseTexture > 0
-        ? mix(uColor, vec4(0.0), innerBoxSdf) * texture(uTexture, vTexCoords)
-        : mix(uColor, vec4(0.0), innerBoxSdf);
+    /* Set the color of the inner content. Negative layer means the instance is not textured. */
+    vec4 finalColor = vTextureLayer >= 0
+        ? mix(vColor, vec4(0.0), innerBoxSdf) * texture(uTexture, vAtlasCoords)
+        : mix(vColor, vec4(0.0), innerBoxSdf);
 
     /* Set the color of the border */
-    finalColor += mix(vec4(0.0), uBorderColor, inOutDiffSdf);
+    finalColor += mix(vec4(0.0), vBorderColor, inOutDiffSdf);
 
     fragColor = finalColor;
-}
\ No newline at end of file
+}
@@ -0,0 +1,43 @@
+#version 440 core
+
+layout (location = 0) in vec3 vPos;
+layout (location = 1) in vec2 vTex;
+
+/* Per instance data. Needs to match BatchRenderer::QuadInstance layout. */
+layout (location = 2) in vec4 iRect;
+layout (location = 3) in vec4 iColor;
+layout (location = 4) in vec4 iBorderSize;
+layout (location = 5) in vec4 iBorderRadii;
+layout (location = 6) in vec4 iBorderColor;
+layout (location = 7) in vec4 iClipRect;
+layout (location = 8) in vec4 iParams; /* x - zIndex, y - texture layer */
+layout (location = 9) in vec4 iUvRect; /* Region of the texture to sample */
+
+uniform mat4 uMatrixProjection;
+
+out vec2 vTexCoords;
+out vec2 vAtlasCoords;
+out vec2 vWorldPos;
+flat out vec4 vColor;
+flat out vec4 vBorderSize;
+flat out vec4 vBorderRadii;
+flat out vec4 vBorderColor;
+flat out vec4 vClipRect;
+flat out vec2 vResolution;
+flat out float vTextureLayer;
+
+void main()
+{
+    vTexCoords = vTex;
+    vAtlasCoords = iUvRect.xy + vTex * iUvRect.zw;
+    vWorldPos = iRect.xy + vPos.xy * iRect.zw;
+    vColor = iColor;
+    vBorderSize = iBorderSize;
+    vBorderRadii = iBorderRadii;
+    vBorderColor = iBorderColor;
+    vClipRect = iClipRect;
+    vResolution = iRect.zw;
+    vTextureLayer = iParams.y;
+
+    gl_Position = uMatrixProjection * vec4(vWorldPos, iParams.x, 1.0f);
+}
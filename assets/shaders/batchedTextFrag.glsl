@@ -0,0 +1,35 @@
+#version 440 core
+
+uniform sampler2DArray uTextureArray;
+uniform int uSdf;
+
+in vec2 vTexCoords;
+in vec2 vWorldPos;
+flat in vec4 vColor;
+flat in vec4 vClipRect;
+flat in float vPage;
+
+out vec4 fragColor;
+
+void main()
+{
+    /* Same per element clipping as for the quads. */
+    if (any(lessThan(vWorldPos, vClipRect.xy)) || any(greaterThanEqual(vWorldPos, vClipRect.xy + vClipRect.zw)))
+    {
+        discard;
+    }
+
+    float t = texture(uTextureArray, vec3(vTexCoords, vPage)).r;
+
+    /* Distance fields have the outline at 0.5, inside is above it. Smooth over about a screen pixel. */
+    if (uSdf == 1)
+    {
+        float w = fwidth(t);
+        t = smoothstep(0.5 - w, 0.5 + w, t);
+    }
+
+    /* Glyphs of a text share one depth. Empty texels must not write it or they'd cut into overlapping
+        neighbours. */
+    if (t <= 0.0) { discard; }
+    fragColor = vec4(vColor.xyz, t);
+}
@@ -0,0 +1,30 @@
+#version 440 core
+
+layout (location = 0) in vec3 vPos;
+layout (location = 1) in vec2 vTex;
+
+/* Per instance data. Needs to match BatchRenderer::GlyphInstance layout. */
+layout (location = 2) in vec4 iRect;
+layout (location = 3) in vec4 iUvRect;
+layout (location = 4) in vec4 iClipRect;
+layout (location = 5) in vec4 iColor;
+layout (location = 6) in vec2 iParams; /* x - zIndex, y - atlas page */
+
+uniform mat4 uMatrixProjection;
+
+out vec2 vTexCoords;
+out vec2 vWorldPos;
+flat out vec4 vColor;
+flat out vec4 vClipRect;
+flat out float vPage;
+
+void main()
+{
+    vTexCoords = iUvRect.xy + vTex * iUvRect.zw;
+    vWorldPos = iRect.xy + vPos.xy * iRect.zw;
+    vColor = iColor;
+    vClipRect = iClipRect;
+    vPage = iParams.y;
+
+    gl_Position = uMatrixProjection * vec4(vWorldPos, iParams.x, 1.0f);
+}
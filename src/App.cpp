@@ -1,23 +1,35 @@
 #include "App.hpp"
 
 #include <algorithm>
+#include <format>
 
 #include "src/Core/Binders/GPUBinder.hpp"
 #include "src/Core/Binders/WindowBinder.hpp"
 #include "src/Core/LavParser/LavParser.hpp"
+#include "src/Core/ResourceHandler/LoadingQueue.hpp"
+#include "src/Core/ResourceHandler/ShaderLoader.hpp"
 #include "src/Node/UIBase.hpp"
 
 namespace lav
 {
 App::~App()
 {
+    /* Workers may still be queueing uploads, they must not wake a terminated GLFW. */
+    core::LoadingQueue::get().setUploadNotifier(nullptr);
     windows_.clear();
     core::WindowBinder::get().terminate();
 }
 
-auto App::init() -> bool
+auto App::init(const bool offscreen) -> bool
 {
-    return core::WindowBinder::get().init() && core::GPUBinder::get().init();
+    if (!core::WindowBinder::get().init(offscreen) || !core::GPUBinder::get().init()) { return false; }
+
+    /* Get every engine program ready before the first window needs it. */
+    core::ShaderLoader::get().warmUp();
+
+    /* Finished background loads need a frame to get uploaded. */
+    core::LoadingQueue::get().setUploadNotifier([]() { core::WindowBinder::get().postEmptyEvent(); });
+    return true;
 }
 
 auto App::loadLavView(const std::filesystem::path& viewPath) -> node::UIWindowWPtr
@@ -45,32 +57,62 @@ auto App::findWindow(const uint64_t windowId) -> node::UIWindowWPtr
 
 auto App::run() -> void
 {
-    shouldUpdateTitle_ = true;
     while (keepRunning_)
     {
-        /* TODO: The FPS counter is broken whenever we have multiple windows. Not sure
-            how nicely it will play out with future animations. */
-        const double startTime{core::WindowBinder::get().getTime()};
-        std::erase_if(windows_, [this](const auto& w) { return runPerWindow(w); });
-        const double now = core::WindowBinder::get().getTime();
-        deltaTime_ = 1.0f / (now - startTime);
-
-        core::WindowBinder::get().pollEvents();
+        const bool continuous = isContinuous();
+        const auto now = std::chrono::steady_clock::now();
+        std::erase_if(windows_, [this, continuous, now](const auto& w)
+        {
+            const auto frameTime = w->getNextFrameTime(continuous);
+            return frameTime && *frameTime <= now && runPerWindow(w);
+        });
 
         if (windows_.empty()) { break; }
+
+        waitForNextFrame();
+    }
+}
+
+auto App::waitForNextFrame() -> void
+{
+    /* Earliest frame any window wants. None at all means only an event can give us something to do. */
+    const bool continuous = isContinuous();
+    std::optional<std::chrono::steady_clock::time_point> nextFrameTime;
+    for (const auto& window : windows_)
+    {
+        const auto frameTime = window->getNextFrameTime(continuous);
+        if (frameTime && (!nextFrameTime || *frameTime < *nextFrameTime)) { nextFrameTime = frameTime; }
+    }
+
+    auto& windowBinder = core::WindowBinder::get();
+    const auto now = std::chrono::steady_clock::now();
+    if (!nextFrameTime)
+    {
+        windowBinder.waitEvents();
+    }
+    else if (*nextFrameTime <= now)
+    {
+        windowBinder.pollEvents();
+    }
+    else
+    {
+        windowBinder.waitEventsTimeout(std::chrono::duration<double>(*nextFrameTime - now).count());
     }
 }
 
+auto App::isContinuous() const -> bool
+{
+    /* Uploads can change any window, they get drained by whichever window runs first. */
+    return !waitEvents_ || core::LoadingQueue::get().hasPendingUploads();
+}
+
 auto App::get() -> App&
 {
     static App instance;
     return instance;
 }
 
-auto App::setWaitEvents(const bool waitEvents) -> void
-{
-    core::WindowBinder::get().setPollWaitForEvents(waitEvents);
-}
+auto App::setWaitEvents(const bool waitEvents) -> void { waitEvents_ = waitEvents; }
 
 auto App::enableTitleWithFPS(const bool enable) -> void { showFps_ = enable; }
 
@@ -82,13 +124,27 @@ auto App::runPerWindow(const node::UIWindowPtr& window) -> bool
         keepRunning_ = false;
     }
 
-    if (showFps_ && shouldUpdateTitle_)
-    {
-        const auto fps = std::to_string(deltaTime_);
-        const auto title = window->getTitle();
-        window->setTitle(title + " | " + fps, false);
-    }
+    if (shouldFrameBeRemoved) { titleStats_.erase(window->getId()); }
+    else if (showFps_) { updateTitleStats(window); }
 
     return shouldFrameBeRemoved;
 }
+
+auto App::updateTitleStats(const node::UIWindowPtr& window) -> void
+{
+    const double now = core::WindowBinder::get().getTime();
+    const uint64_t renderedFrames = window->getRenderedFramesCount();
+    const auto [it, isNew] = titleStats_.try_emplace(window->getId(), TitleStats{now, renderedFrames});
+    if (isNew || now - it->second.time < TITLE_STATS_PERIOD) { return; }
+
+    /* Frames rendered per second of wall time, each window on its own. Skipped frames don't count. */
+    using Metric = core::FrameStats::Metric;
+    const double fps = (renderedFrames - it->second.renderedFrames) / (now - it->second.time);
+    const auto cpu = window->getFrameStats().getPercentiles(Metric::CPU_TIME_US);
+    const auto gpu = window->getFrameStats().getPercentiles(Metric::GPU_TIME_US);
+    window->setTitle(std::format("{} | {:.0f} fps | cpu p50/p99 {:.2f}/{:.2f} ms | gpu p50/p99 {:.2f}/{:.2f} ms",
+        window->getTitle(), fps, cpu.p50 / 1000, cpu.p99 / 1000, gpu.p50 / 1000, gpu.p99 / 1000), false);
+
+    it->second = {now, renderedFrames};
+}
 } // namespace lav
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <filesystem>
+#include <unordered_map>
 #include <vector>
 
 #include "src/Node/UIWindow.hpp"
@@ -19,6 +20,8 @@ namespace lav
             as the run() command due to reference counting keeping the window alive even if the exit event was issued.
             You as the caller don't own anything the callee created aka you only get a weak reference to the window.
     @note 4. Upon calling run() calling thread will block until main window is closed.
+    @note 5. run() only runs the windows that have something to do and sleeps until the next one does. Input,
+        finished background loads and UIWindow::requestFrame() wake it up.
 */
 class App
 {
@@ -30,26 +33,59 @@ public:
 
     static auto get() -> App&;
 
-    auto init() -> bool;
+    /**
+        @brief Initialize windowing and rendering.
+
+        @param offscreen Render without any display server, see WindowBinder::init()
+
+        @return True on success.
+    */
+    auto init(const bool offscreen = false) -> bool;
     auto run() -> void;
     auto loadLavView(const std::filesystem::path& viewPath) -> node::UIWindowWPtr;
     auto createWindow(const std::string& title, const glm::ivec2 size) -> node::UIWindowWPtr;
     auto findWindow(const uint64_t windowId) -> node::UIWindowWPtr;
+
+    /**
+        @brief Choose between rendering on demand and rendering continuously.
+
+        @param waitEvents True (default) to only run windows when something changed and sleep otherwise.
+            False to run them back to back, still capped by their target frame rates and vsync
+    */
     auto setWaitEvents(const bool waitEvents = true) -> void;
+
+    /**
+        @brief Show the FPS and frame time percentiles in each window's title.
+
+        @note Titles are only refreshed every TITLE_STATS_PERIOD seconds, setting one is a round trip to the
+            display server.
+    */
     auto enableTitleWithFPS(const bool enable = true) -> void;
 
 private:
+    /** @brief What a window's title showed last. */
+    struct TitleStats
+    {
+        double time{0};
+        uint64_t renderedFrames{0};
+    };
+
     App() = default;
     ~App();
 
     auto runPerWindow(const node::UIWindowPtr& frame) -> bool;
+    auto waitForNextFrame() -> void;
+    auto isContinuous() const -> bool;
+    auto updateTitleStats(const node::UIWindowPtr& window) -> void;
 
 private:
+    static constexpr double TITLE_STATS_PERIOD{0.5};
+
     utils::Logger log_{"App"};
     std::vector<node::UIWindowPtr> windows_;
-    double deltaTime_{0};
+    std::unordered_map<uint32_t, TitleStats> titleStats_;
     bool keepRunning_{true};
-    bool shouldUpdateTitle_{false};
     bool showFps_{false};
+    bool waitEvents_{true};
 };
 } // namespace lav
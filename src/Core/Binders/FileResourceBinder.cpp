@@ -1,5 +1,12 @@
 #include "FileResourceBinder.hpp"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
 #define STB_IMAGE_IMPLEMENTATION
 #include "vendor/stb/stbi_image.hpp"
 
@@ -13,6 +20,8 @@ auto FileResourceBinder::get() -> FileResourceBinder&
 
 auto FileResourceBinder::loadTextureData(const std::filesystem::path& path) const -> LoadInfo
 {
+    if (path.extension() == ".ktx2") { return loadKtx2Data(path); }
+
     LoadInfo info;
     unsigned char* data = stbi_load(path.c_str(), &info.width, &info.height, &info.numChannels, 0);
     if (!data)
@@ -29,8 +38,119 @@ auto FileResourceBinder::loadTextureData(const std::filesystem::path& path) cons
     return info;
 }
 
+auto FileResourceBinder::loadKtx2Data(const std::filesystem::path& path) const -> LoadInfo
+{
+    LoadInfo info;
+    info.fileExt = FileExt::KTX2;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        log_.error("Cannot load texture '{}'. Check path correctness!", path.string());
+        return info;
+    }
+    const std::vector<uint8_t> bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+    /* Header is 12 bytes of identifier, 9 uint32 fields and the 32 byte index. Levels follow. */
+    static constexpr std::array<uint8_t, 12> identifier{
+        0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+    static constexpr std::size_t levelIndexOffset{80};
+    if (bytes.size() < levelIndexOffset || !std::equal(identifier.begin(), identifier.end(), bytes.begin()))
+    {
+        log_.error("Texture '{}' is not a KTX2 file", path.string());
+        return info;
+    }
+
+    const auto readU32 = [&bytes](const std::size_t offset)
+    {
+        uint32_t value;
+        std::memcpy(&value, bytes.data() + offset, sizeof(value));
+        return value;
+    };
+    const auto readU64 = [&bytes](const std::size_t offset)
+    {
+        uint64_t value;
+        std::memcpy(&value, bytes.data() + offset, sizeof(value));
+        return value;
+    };
+
+    /* Vulkan format ids. Both UNORM and SRGB variants are sampled as UNORM. */
+    const uint32_t vkFormat = readU32(12);
+    switch (vkFormat)
+    {
+        case 131: case 132: case 133: case 134: info.compressedFormat = GPUBinder::CompressedFormat::BC1; break;
+        case 137: case 138: info.compressedFormat = GPUBinder::CompressedFormat::BC3; break;
+        case 145: case 146: info.compressedFormat = GPUBinder::CompressedFormat::BC7; break;
+        case 147: case 148: info.compressedFormat = GPUBinder::CompressedFormat::ETC2_RGB; break;
+        case 151: case 152: info.compressedFormat = GPUBinder::CompressedFormat::ETC2_RGBA; break;
+        default:
+            log_.error("Texture '{}' uses unsupported KTX2 format {}", path.string(), vkFormat);
+            return info;
+    }
+
+    const uint32_t supercompression = readU32(44);
+    if (supercompression != 0)
+    {
+        log_.error("Texture '{}' uses KTX2 supercompression {}, only raw blocks are supported",
+            path.string(), supercompression);
+        return info;
+    }
+
+    /* Everything below comes from the file, so sizes are checked before any of it gets used. */
+    const uint32_t width = readU32(20);
+    const uint32_t height = readU32(24);
+    static constexpr uint32_t maxDimension = std::numeric_limits<int32_t>::max();
+    if (width == 0 || height == 0 || width > maxDimension || height > maxDimension)
+    {
+        log_.error("Texture '{}' has an invalid KTX2 size {}x{}", path.string(), width, height);
+        return info;
+    }
+
+    /* Zero levels means the consumer is expected to generate them. Only the base is stored then. A full
+        chain goes down to 1x1, there can't be more levels than that. */
+    const uint32_t levelCount = std::max(readU32(40), 1u);
+    const uint32_t maxLevelCount = std::bit_width(std::max(width, height));
+    if (levelCount > maxLevelCount)
+    {
+        log_.error("Texture '{}' claims {} KTX2 levels, at most {} fit its size", path.string(), levelCount,
+            maxLevelCount);
+        return info;
+    }
+
+    static constexpr std::size_t levelIndexEntrySize{24};
+    if (bytes.size() < levelIndexOffset + std::size_t{levelCount} * levelIndexEntrySize)
+    {
+        log_.error("Texture '{}' has a truncated KTX2 level index", path.string());
+        return info;
+    }
+
+    info.width = width;
+    info.height = height;
+    info.numChannels = 4;
+    for (uint32_t level = 0; level < levelCount; ++level)
+    {
+        const std::size_t entryOffset = levelIndexOffset + std::size_t{level} * levelIndexEntrySize;
+        const uint64_t offset = readU64(entryOffset);
+        const uint64_t length = readU64(entryOffset + 8);
+        if (offset > bytes.size() || length > bytes.size() - offset)
+        {
+            log_.error("Texture '{}' has a truncated KTX2 level {}", path.string(), level);
+            info.levels.clear();
+            return info;
+        }
+        info.levels.emplace_back(bytes.begin() + offset, bytes.begin() + offset + length);
+    }
+
+    log_.debug("KTX2 texture data loaded to host for '{}' with {} levels", path.string(), levelCount);
+
+    return info;
+}
+
 auto FileResourceBinder::freeLoadedTextureData(const LoadInfo& info) const -> void
 {
+    /* KTX2 data is owned by the info itself. */
+    if (info.fileExt == FileExt::KTX2) { return; }
+
     if (info.data == nullptr)
     {
         log_.warn("Tried to free texture data pointing to null!");
@@ -2,6 +2,10 @@
 
 #include "src/Utils/Logger.hpp"
 #include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "src/Core/Binders/GPUBinder.hpp"
 
 namespace lav::core
 {
@@ -13,7 +17,8 @@ public:
     {
         JPEG,
         JPG,
-        PNG
+        PNG,
+        KTX2
     };
 
     struct LoadInfo
@@ -23,6 +28,12 @@ public:
         int32_t height{0};
         int32_t numChannels{0};
         FileExt fileExt{FileExt::JPEG};
+
+        /* Only for KTX2. Block data of each mip level, base level first. `data` stays null. */
+        std::optional<GPUBinder::CompressedFormat> compressedFormat;
+        std::vector<std::vector<uint8_t>> levels;
+
+        auto isValid() const -> bool { return data || !levels.empty(); }
     };
 
 public:
@@ -31,6 +42,9 @@ public:
     auto loadTextureData(const std::filesystem::path& path) const -> LoadInfo;
     auto freeLoadedTextureData(const LoadInfo&) const -> void;
 
+private:
+    auto loadKtx2Data(const std::filesystem::path& path) const -> LoadInfo;
+
 private:
     FileResourceBinder() = default;
     FileResourceBinder(const FileResourceBinder&) = delete;
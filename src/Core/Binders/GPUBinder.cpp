@@ -2,6 +2,8 @@
 
 #include "vendor/glew/include/GL/glew.h"
 #include "vendor/glm/gtc/type_ptr.hpp"
+#include <algorithm>
+#include <cmath>
 #include <numeric>
 #include <type_traits>
 
@@ -15,7 +17,10 @@ auto GPUBinder::get() -> GPUBinder&
 
 auto GPUBinder::init() -> bool
 {
-    if (glewInit() != GLEW_OK)
+    /* GL entry points are loaded before GLX ones, so a missing GLX display (surfaceless EGL context) still
+        leaves a usable GL behind. */
+    const GLenum glewStatus = glewInit();
+    if (glewStatus != GLEW_OK && glewStatus != GLEW_ERROR_NO_GLX_DISPLAY)
     {
         log_.error("Couldn't initialize GLEW.");
         return false;
@@ -49,26 +54,39 @@ auto GPUBinder::setViewportArea(const glm::ivec4& area) -> void
 {
     /* [x,y] start [z, w] end from bottom left to top right. */
     glViewport(area.x, area.y, area.z, area.w);
+    ++stats_.glCalls;
 }
 
 auto GPUBinder::setScissorsArea(const glm::ivec4& area) -> void
 {
     /* [x,y] start [z, w] end from bottom left to top right. */
     glScissor(area.x, area.y, area.z, area.w);
+    ++stats_.glCalls;
 }
 
 auto GPUBinder::clearColor(const glm::vec4& color) -> void
 {
     glClearColor(color.r, color.g, color.b, color.a);
+    ++stats_.glCalls;
 }
 
 auto GPUBinder::clearAllBufferBits() -> void
 {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    ++stats_.glCalls;
 }
 
 auto GPUBinder::enable(const Function func, const bool enable) -> void
 {
+    auto& enabled = renderState_.enabled[static_cast<uint8_t>(func)];
+    if (enabled == static_cast<uint32_t>(enable))
+    {
+        ++stats_.redundantCallsSkipped;
+        return;
+    }
+    enabled = enable;
+
+    ++stats_.glCalls;
     switch (func)
     {
         case Function::SCISSORS:
@@ -91,11 +109,22 @@ auto GPUBinder::enable(const Function func, const bool enable) -> void
 auto GPUBinder::renderBoundQuad() const -> void
 {
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    ++stats_.glCalls;
+    ++stats_.drawCalls;
 }
 
-auto GPUBinder::renderBoundQuadInstanced(const uint32_t size) const -> void
+auto GPUBinder::renderBoundQuadInstanced(const uint32_t size, const uint32_t baseInstance) const -> void
 {
-    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, size);
+    ++stats_.glCalls;
+    ++stats_.drawCalls;
+    if (!baseInstance)
+    {
+        glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, size);
+        return;
+    }
+
+    /* Per instance attributes will start reading from `baseInstance` onwards. */
+    glDrawElementsInstancedBaseInstance(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, size, baseInstance);
 }
 
 auto GPUBinder::generateTexture() const -> uint32_t
@@ -114,13 +143,35 @@ auto GPUBinder::activateTextureSlot(const uint8_t textureSlot) const -> void
         return;
     }
 
+    if (renderState_.activeSlot == textureSlot)
+    {
+        ++stats_.redundantCallsSkipped;
+        return;
+    }
+    renderState_.activeSlot = textureSlot;
+
     /* Active unit needs to be indeed [GL_TEXTURE0..maxGL_TEXTURE] */
     glActiveTexture(GL_TEXTURE0 + textureSlot);
+    ++stats_.glCalls;
 }
 
 auto GPUBinder::bindIdToTextureType(const TextureType texType, const uint32_t texId) const -> void
 {
+    /* Binding goes to whatever slot is active. Untracked slots always go through. */
+    const uint32_t slot = renderState_.activeSlot;
+    if (slot < MAX_TRACKED_SLOTS)
+    {
+        auto& boundId = renderState_.textures[slot][static_cast<uint8_t>(texType)];
+        if (boundId == texId)
+        {
+            ++stats_.redundantCallsSkipped;
+            return;
+        }
+        boundId = texId;
+    }
+
     glBindTexture(convertTextureType(texType), texId);
+    ++stats_.glCalls;
 }
 
 auto GPUBinder::createTexture(const uint32_t width, const uint32_t height, const uint32_t sliceCount,
@@ -134,15 +185,17 @@ auto GPUBinder::createTexture(const uint32_t width, const uint32_t height, const
 
     const auto convertedTexType = convertTextureType(texType);
     const auto convertedColorType = convertColorType(colType);
+    const auto internalFormat = convertInternalFormat(colType);
     if (!convertedTexType || !convertedColorType) { return 0; }
 
     bindIdToTextureType(texType, id);
 
-    /* Wrapping, mag & min settings. */
-    glTexParameteri(convertedTexType, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(convertedTexType, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(convertedTexType, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(convertedTexType, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    /* Wrapping, mag & min settings. Without mipmaps the texture is limited to its base level so it's
+        complete whatever the min filter asks for. */
+    const uint32_t mipLevels = texOpts.generateMipmaps
+        ? static_cast<uint32_t>(std::log2(std::max({width, height, 1u}))) + 1
+        : 1;
+    applyTextureOptions(texType, texOpts, mipLevels);
 
     /* Single 2D Image. */
     if (texType == GPUBinder::TextureType::Single2D)
@@ -150,7 +203,7 @@ auto GPUBinder::createTexture(const uint32_t width, const uint32_t height, const
         glTexImage2D(
             convertedTexType,
             0, /* Level */
-            convertedColorType,
+            internalFormat,
             width,
             height,
             0 /* Border */,
@@ -164,7 +217,7 @@ auto GPUBinder::createTexture(const uint32_t width, const uint32_t height, const
         glTexImage3D(
             convertedTexType,
             0, /* Level */
-            convertedColorType,
+            internalFormat,
             width,
             height,
             sliceCount,
@@ -174,12 +227,103 @@ auto GPUBinder::createTexture(const uint32_t width, const uint32_t height, const
             data);
     }
 
+    /* Textures filled in later need to call generateMipmaps() themselves once done. */
+    if (texOpts.generateMipmaps && data) { glGenerateMipmap(convertedTexType); }
+
     /* Warning. This shall be rebound whenever it is needed! */
-    glBindTexture(convertedTexType, 0);
+    bindIdToTextureType(texType, 0);
 
     return id;
 }
 
+auto GPUBinder::generateMipmaps(const TextureType texType, const uint32_t texId) const -> void
+{
+    const auto convertedTexType = convertTextureType(texType);
+    if (!convertedTexType) { return; }
+
+    bindIdToTextureType(texType, texId);
+    glGenerateMipmap(convertedTexType);
+    bindIdToTextureType(texType, 0);
+    ++stats_.glCalls;
+}
+
+auto GPUBinder::createCompressedTexture(const glm::ivec2& size, const CompressedFormat format,
+    const std::vector<std::vector<uint8_t>>& levels, const TextureOptions& texOpts) const -> uint32_t
+{
+    if (levels.empty() || !isCompressedFormatSupported(format)) { return 0; }
+
+    uint32_t id{generateTexture()};
+    activateTextureSlot(0);
+    bindIdToTextureType(TextureType::Single2D, id);
+
+    /* Compressed textures can't have mipmaps generated, only the shipped levels exist. */
+    applyTextureOptions(TextureType::Single2D, texOpts, levels.size());
+
+    const uint32_t glFormat = convertCompressedFormat(format);
+    glm::ivec2 levelSize{size};
+    for (uint32_t level = 0; level < levels.size(); ++level)
+    {
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, glFormat, levelSize.x, levelSize.y, 0,
+            levels[level].size(), levels[level].data());
+        levelSize = glm::max(levelSize / 2, glm::ivec2{1, 1});
+    }
+    stats_.glCalls += levels.size();
+
+    bindIdToTextureType(TextureType::Single2D, 0);
+
+    return id;
+}
+
+auto GPUBinder::isCompressedFormatSupported(const CompressedFormat format) const -> bool
+{
+    switch (format)
+    {
+        case CompressedFormat::BC1:
+        case CompressedFormat::BC3:
+            return GLEW_EXT_texture_compression_s3tc;
+        case CompressedFormat::BC7:
+            return GLEW_VERSION_4_2 || GLEW_ARB_texture_compression_bptc;
+        case CompressedFormat::ETC2_RGB:
+        case CompressedFormat::ETC2_RGBA:
+            return GLEW_VERSION_4_3 || GLEW_ARB_ES3_compatibility;
+    }
+    return false;
+}
+
+auto GPUBinder::applyTextureOptions(const TextureType texType, const TextureOptions& texOpts,
+    const uint32_t mipLevels) const -> void
+{
+    /* Note: Assumes the texture is already bound. */
+    const auto convertedTexType = convertTextureType(texType);
+    glTexParameteri(convertedTexType, GL_TEXTURE_WRAP_S, convertTextureWrap(texOpts.uWrap));
+    glTexParameteri(convertedTexType, GL_TEXTURE_WRAP_T, convertTextureWrap(texOpts.vWrap));
+    glTexParameteri(convertedTexType, GL_TEXTURE_MIN_FILTER, convertTextureFilter(texOpts.min));
+    glTexParameteri(convertedTexType, GL_TEXTURE_MAG_FILTER, convertTextureFilter(texOpts.mag));
+    glTexParameteri(convertedTexType, GL_TEXTURE_MAX_LEVEL, std::max(mipLevels, 1u) - 1);
+    stats_.glCalls += 5;
+
+    const float anisotropy = std::min(texOpts.anisotropy, getMaxAnisotropy());
+    if (anisotropy > 1.0f)
+    {
+        glTexParameterf(convertedTexType, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropy);
+        ++stats_.glCalls;
+    }
+}
+
+auto GPUBinder::getMaxAnisotropy() const -> float
+{
+    /* Doesn't change during the lifetime of the context so query it only once. */
+    if (maxAnisotropy_ < 0.0f)
+    {
+        maxAnisotropy_ = 1.0f;
+        if (GLEW_EXT_texture_filter_anisotropic)
+        {
+            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy_);
+        }
+    }
+    return maxAnisotropy_;
+}
+
 auto GPUBinder::bufferTextureData(const uint32_t width, const uint32_t height, const uint32_t sliceDepth,
     const TextureType texType, const ColorType colType, unsigned char* data) -> void
 {
@@ -210,6 +354,65 @@ auto GPUBinder::bufferTextureData(const uint32_t width, const uint32_t height, c
     }
 }
 
+auto GPUBinder::bufferTextureSubData(const glm::ivec4& region, const uint32_t slice, const uint32_t rowLength,
+    const TextureType texType, const ColorType colType, const unsigned char* data) const -> void
+{
+    /* Note: Using this assumes the texture is bound to the needed type and a texture slot is in use.
+        `data` points to the whole image, `rowLength` pixels wide. Only `region` of it is sent. */
+    const auto convertedTexType = convertTextureType(texType);
+    const auto convertedColorType = convertColorType(colType);
+    if (!convertedTexType || !convertedColorType) { return; }
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, region.x);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, region.y);
+
+    if (texType == GPUBinder::TextureType::Single2D)
+    {
+        glTexSubImage2D(convertedTexType, 0, region.x, region.y, region.z, region.w,
+            convertedColorType, GL_UNSIGNED_BYTE, data);
+    }
+    else if (texType == GPUBinder::TextureType::Array2D)
+    {
+        glTexSubImage3D(convertedTexType, 0, region.x, region.y, slice, region.z, region.w, 1,
+            convertedColorType, GL_UNSIGNED_BYTE, data);
+    }
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+    stats_.glCalls += 7;
+}
+
+auto GPUBinder::bufferTextureRegion(const glm::ivec4& region, const uint32_t slice, const TextureType texType,
+    const ColorType colType, const unsigned char* data) const -> void
+{
+    /* Note: Same as bufferTextureSubData but `data` holds only the region, tightly packed. */
+    const auto convertedTexType = convertTextureType(texType);
+    const auto convertedColorType = convertColorType(colType);
+    if (!convertedTexType || !convertedColorType) { return; }
+
+    if (texType == GPUBinder::TextureType::Single2D)
+    {
+        glTexSubImage2D(convertedTexType, 0, region.x, region.y, region.z, region.w,
+            convertedColorType, GL_UNSIGNED_BYTE, data);
+    }
+    else if (texType == GPUBinder::TextureType::Array2D)
+    {
+        glTexSubImage3D(convertedTexType, 0, region.x, region.y, slice, region.z, region.w, 1,
+            convertedColorType, GL_UNSIGNED_BYTE, data);
+    }
+    ++stats_.glCalls;
+}
+
+auto GPUBinder::deleteTexture(const uint32_t texId) const -> void
+{
+    if (!texId) { return; }
+    glDeleteTextures(1, &texId);
+    ++stats_.glCalls;
+    forgetTexture(texId);
+}
+
 auto GPUBinder::unpackAlignment(const uint32_t bytes) const -> void
 {
     glPixelStorei(GL_UNPACK_ALIGNMENT, bytes);
@@ -222,46 +425,146 @@ auto GPUBinder::createProgram() const -> uint32_t
 
 auto GPUBinder::loadShaderPartType(const ShaderPartType type, const std::string& data) const -> uint32_t
 {
+    uint32_t id{compileShaderPart(type, data)};
+    if (!isStausOk(id, ShaderStatusQuerry::COMPILE))
+    {
+        log_.error("Loading shader part failure!");
+        deleteShaderPart(id);
+        return 0;
+    }
+    return id;
+}
+
+auto GPUBinder::compileShaderPart(const ShaderPartType type, const std::string& data) const -> uint32_t
+{
+    /* Status is not queried here. Drivers can compile in the background until someone asks for it. */
     uint32_t id{glCreateShader(convertShaderPartType(type))};
 
     const char* dataIn = data.c_str();
     glShaderSource(id, 1, &dataIn, nullptr);
     glCompileShader(id);
+    return id;
+}
 
-    if (!isStausOk(id, ShaderStatusQuerry::COMPILE))
+auto GPUBinder::deleteShaderPart(const uint32_t partId) const -> void { glDeleteShader(partId); }
+
+auto GPUBinder::linkPartsToProgram(const uint32_t programId, const uint32_t vertexId, const uint32_t fragId) -> bool
+{
+    linkParts(programId, vertexId, fragId);
+    if (!isProgramLinked(programId))
     {
-        log_.error("Loading shader part failure!");
-        return 0;
+        log_.error("Linking failure for program '{}'!", programId);
+        return false;
     }
-    return id;
+
+    return true;
 }
 
-auto GPUBinder::linkPartsToProgram(const uint32_t programId, const uint32_t vertexId, const uint32_t fragId) -> bool
+auto GPUBinder::linkParts(const uint32_t programId, const uint32_t vertexId, const uint32_t fragId) const -> void
 {
+    if (isProgramBinarySupported())
+    {
+        glProgramParameteri(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
     glAttachShader(programId, vertexId);
     glAttachShader(programId, fragId);
     glLinkProgram(programId);
+
+    /* Only flagged for deletion, they go away once detached from the program. */
     glDeleteShader(vertexId);
     glDeleteShader(fragId);
+}
+
+auto GPUBinder::isProgramLinked(const uint32_t programId) const -> bool
+{
+    return isStausOk(programId, ShaderStatusQuerry::LINK);
+}
+
+auto GPUBinder::deleteProgram(const uint32_t programId) const -> void
+{
+    glDeleteProgram(programId);
+    uniformLocations_.erase(programId);
+    if (renderState_.program == programId) { renderState_.program = UNKNOWN; }
+}
+
+auto GPUBinder::getProgramBinary(const uint32_t programId, uint32_t& format) const -> std::vector<uint8_t>
+{
+    if (!isProgramBinarySupported()) { return {}; }
+
+    int32_t length{0};
+    glGetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) { return {}; }
+
+    std::vector<uint8_t> data(length);
+    int32_t written{0};
+    glGetProgramBinary(programId, length, &written, &format, data.data());
+    data.resize(written);
+    return data;
+}
 
-    if (!isStausOk(programId, ShaderStatusQuerry::LINK))
+auto GPUBinder::loadProgramBinary(const uint32_t programId, const uint32_t format,
+    const std::vector<uint8_t>& data) const -> bool
+{
+    if (!isProgramBinarySupported() || data.empty()) { return false; }
+
+    glProgramBinary(programId, format, data.data(), data.size());
+
+    /* Not going through isStausOk, a rejected binary is expected and shouldn't be logged as an error. */
+    int32_t ok{0};
+    glGetProgramiv(programId, GL_LINK_STATUS, &ok);
+    return ok;
+}
+
+auto GPUBinder::isProgramBinarySupported() const -> bool
+{
+    /* Doesn't change during the lifetime of the context so query it only once. */
+    if (programBinaryFormats_ < 0)
     {
-        log_.error("Linking failure for program '{}'!", programId);
-        return false;
+        programBinaryFormats_ = 0;
+        if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)
+        {
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &programBinaryFormats_);
+        }
     }
+    return programBinaryFormats_ > 0;
+}
 
-    return true;
+auto GPUBinder::getDriverString() const -> std::string
+{
+    const auto str = [](const uint32_t name)
+    {
+        const auto* value = reinterpret_cast<const char*>(glGetString(name));
+        return std::string{value ? value : ""};
+    };
+    return str(GL_VENDOR) + "|" + str(GL_RENDERER) + "|" + str(GL_VERSION);
 }
 
 auto GPUBinder::useProgram(const uint32_t programId) const -> void
 {
+    if (renderState_.program == programId)
+    {
+        ++stats_.redundantCallsSkipped;
+        return;
+    }
+    renderState_.program = programId;
+
     glUseProgram(programId);
+    ++stats_.glCalls;
+}
+
+template<typename T>
+auto GPUBinder::uploadUniform(const uint32_t programId, const std::string_view name, const T& val) const -> bool
+{
+    return uploadUniform(getUniformLocation(programId, name), val);
 }
 
 template<typename T>
-auto GPUBinder::uploadUniform(const uint32_t programId, const std::string& name, const T& val) const -> bool
+auto GPUBinder::uploadUniform(const int32_t location, const T& val) const -> bool
 {
-    const auto location = getUniformLocation(programId, name);
+    /* Nothing to upload to. GL would silently ignore it anyway. */
+    if (location == -1) { return false; }
+
     if constexpr (std::is_same_v<T, glm::mat4>)
     {
         glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(val));
@@ -278,6 +581,10 @@ auto GPUBinder::uploadUniform(const uint32_t programId, const std::string& name,
     {
         glUniform4f(location, val.x, val.y, val.z, val.w);
     }
+    else if constexpr (std::is_same_v<T, std::vector<glm::vec4>>)
+    {
+        glUniform4fv(location, val.size(), glm::value_ptr(val[0]));
+    }
     else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>)
     {
         glUniform1i(location, val);
@@ -289,13 +596,22 @@ auto GPUBinder::uploadUniform(const uint32_t programId, const std::string& name,
     else
     {
         log_.error("Unsupported upload type!");
+        return false;
     }
 
-    return location == -1 ? false : true;
+    ++stats_.glCalls;
+    ++stats_.uniformUploads;
+    return true;
 }
 
-auto GPUBinder::uploadUniformTexture(const uint32_t programId, const std::string& name, const TextureType type,
+auto GPUBinder::uploadUniformTexture(const uint32_t programId, const std::string_view name, const TextureType type,
         const uint32_t texSlot, const uint32_t texId) const -> bool
+{
+    return uploadUniformTexture(getUniformLocation(programId, name), type, texSlot, texId);
+}
+
+auto GPUBinder::uploadUniformTexture(const int32_t location, const TextureType type, const uint32_t texSlot,
+    const uint32_t texId) const -> bool
 {
     const auto maxSlots = getMaxTextureSlots();
     if (texSlot + 1 > maxSlots)
@@ -306,27 +622,231 @@ auto GPUBinder::uploadUniformTexture(const uint32_t programId, const std::string
     }
 
     /* Shader needs texture slot location in range from [0..maxSlot], not from [GL_TEXTURE0..maxGL_TEXTURE] */
-    uploadUniform(programId, name, texSlot);
+    if (!uploadUniform(location, texSlot)) { return false; }
 
     activateTextureSlot(texSlot);
-
-    const auto& convertedType = convertTextureType(type);
-    glBindTexture(convertedType, texId);
-    return convertedType;
+    bindIdToTextureType(type, texId);
+    return convertTextureType(type);
 }
 
 auto GPUBinder::getMaxTextureSlots() const -> uint32_t
 {
-    int32_t maxTextureSlots;
-    glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxTextureSlots);
-    return maxTextureSlots;
+    /* Doesn't change during the lifetime of the context so query it only once. */
+    if (maxTextureSlots_ == -1)
+    {
+        glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxTextureSlots_);
+    }
+    return maxTextureSlots_;
+}
+
+auto GPUBinder::getUniformLocation(const uint32_t programId, const std::string_view name) const -> int32_t
+{
+    /* Locations never change after linking so resolve each (program, name) pair only once. Misses are
+        cached as well so a typo doesn't query GL every frame. */
+    auto& programLocations = uniformLocations_[programId];
+    if (const auto it = programLocations.find(name); it != programLocations.end())
+    {
+        return it->second;
+    }
+
+    std::string nameStr{name};
+    const int32_t location = glGetUniformLocation(programId, nameStr.c_str());
+    ++stats_.glCalls;
+    ++stats_.locationQueries;
+
+    programLocations.emplace(std::move(nameStr), location);
+    return location;
+}
+
+auto GPUBinder::createFramebuffer(const glm::ivec2& size) const -> Framebuffer
+{
+    Framebuffer framebuffer{.size = size};
+
+    glGenFramebuffers(1, &framebuffer.id);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.id);
+
+    glGenTextures(1, &framebuffer.colorTexId);
+    bindIdToTextureType(TextureType::Single2D, framebuffer.colorTexId);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    bindIdToTextureType(TextureType::Single2D, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, framebuffer.colorTexId, 0);
+
+    glGenRenderbuffers(1, &framebuffer.depthRbId);
+    glBindRenderbuffer(GL_RENDERBUFFER, framebuffer.depthRbId);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, size.x, size.y);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, framebuffer.depthRbId);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        log_.error("Framebuffer of size {}x{} is not complete!", size.x, size.y);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return framebuffer;
+}
+
+auto GPUBinder::deleteFramebuffer(Framebuffer& framebuffer) const -> void
+{
+    if (!framebuffer.id) { return; }
+
+    glDeleteFramebuffers(1, &framebuffer.id);
+    glDeleteTextures(1, &framebuffer.colorTexId);
+    glDeleteRenderbuffers(1, &framebuffer.depthRbId);
+    forgetTexture(framebuffer.colorTexId);
+    framebuffer = {};
+}
+
+auto GPUBinder::bindFramebuffer(const uint32_t framebufferId) const -> void
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, framebufferId);
+    ++stats_.glCalls;
+}
+
+auto GPUBinder::blitFramebufferToScreen(const Framebuffer& framebuffer) const -> void
+{
+    /* Note: Blitting is affected by the scissor area. Whole screen needs to be set beforehand. */
+    const auto& size = framebuffer.size;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer.id);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, size.x, size.y, 0, 0, size.x, size.y, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    stats_.glCalls += 4;
+}
+
+auto GPUBinder::startReadback(Readback& readback, const uint32_t framebufferId, const glm::ivec2& size) const -> void
+{
+    if (readback.fence) { glDeleteSync(static_cast<GLsync>(readback.fence)); }
+    if (!readback.bufferId) { glGenBuffers(1, &readback.bufferId); }
+
+    const uint64_t bytes = uint64_t(size.x) * size.y * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.bufferId);
+    if (bytes > readback.capacity)
+    {
+        glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+        readback.capacity = bytes;
+    }
+
+    /* With a pack buffer bound, the copy lands in the buffer and the call doesn't wait for the GPU. */
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebufferId);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readback.size = size;
+    stats_.glCalls += 6;
+}
+
+auto GPUBinder::isReadbackReady(const Readback& readback) const -> bool
+{
+    if (!readback.fence) { return false; }
+
+    /* Zero timeout, only polls. Flushing makes sure the fence gets signaled at all. */
+    const GLenum status = glClientWaitSync(static_cast<GLsync>(readback.fence), GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    ++stats_.glCalls;
+    return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+}
+
+auto GPUBinder::finishReadback(Readback& readback, std::vector<uint8_t>& pixels) const -> bool
+{
+    if (!readback.fence) { return false; }
+
+    glDeleteSync(static_cast<GLsync>(readback.fence));
+    readback.fence = nullptr;
+
+    const auto& size = readback.size;
+    const uint64_t rowBytes = uint64_t(size.x) * 4;
+    const uint64_t bytes = rowBytes * size.y;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.bufferId);
+    const auto* mapped = static_cast<const uint8_t*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes, GL_MAP_READ_BIT));
+    if (!mapped)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        log_.error("Couldn't map read back buffer {}", readback.bufferId);
+        return false;
+    }
+
+    /* GL rows go bottom up, images top down. */
+    pixels.resize(bytes);
+    for (int32_t row = 0; row < size.y; ++row)
+    {
+        std::copy_n(mapped + (size.y - 1 - row) * rowBytes, rowBytes, pixels.data() + row * rowBytes);
+    }
+
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    stats_.glCalls += 4;
+    return true;
+}
+
+auto GPUBinder::deleteReadback(Readback& readback) const -> void
+{
+    if (readback.fence) { glDeleteSync(static_cast<GLsync>(readback.fence)); }
+    if (readback.bufferId) { glDeleteBuffers(1, &readback.bufferId); }
+    readback = {};
+}
+
+auto GPUBinder::createTimerQuery() const -> uint32_t
+{
+    uint32_t queryId{0};
+    glGenQueries(1, &queryId);
+    ++stats_.glCalls;
+    return queryId;
 }
 
-auto GPUBinder::getUniformLocation(const uint32_t programId, const std::string& name) const -> int32_t
+auto GPUBinder::deleteTimerQuery(uint32_t& queryId) const -> void
 {
-    return glGetUniformLocation(programId, name.c_str());
+    if (!queryId) { return; }
+    glDeleteQueries(1, &queryId);
+    ++stats_.glCalls;
+    queryId = 0;
 }
 
+auto GPUBinder::beginTimerQuery(const uint32_t queryId) const -> void
+{
+    glBeginQuery(GL_TIME_ELAPSED, queryId);
+    ++stats_.glCalls;
+}
+
+auto GPUBinder::endTimerQuery() const -> void
+{
+    glEndQuery(GL_TIME_ELAPSED);
+    ++stats_.glCalls;
+}
+
+auto GPUBinder::getTimerQueryResult(const uint32_t queryId) const -> std::optional<uint64_t>
+{
+    /* Asking for the result before it's available would stall until the GPU catches up. */
+    int32_t isAvailable{0};
+    glGetQueryObjectiv(queryId, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+    ++stats_.glCalls;
+    if (!isAvailable) { return std::nullopt; }
+
+    uint64_t elapsedNs{0};
+    glGetQueryObjectui64v(queryId, GL_QUERY_RESULT, &elapsedNs);
+    ++stats_.glCalls;
+    return elapsedNs;
+}
+
+auto GPUBinder::invalidateRenderState() const -> void { renderState_.invalidate(); }
+
+auto GPUBinder::forgetTexture(const uint32_t texId) const -> void
+{
+    /* GL reverts bindings of deleted textures to zero. Ids get reused so the cache has to follow. */
+    for (auto& slot : renderState_.textures)
+    {
+        std::ranges::replace(slot, texId, 0u);
+    }
+}
+
+auto GPUBinder::getStats() const -> const Stats& { return stats_; }
+
+auto GPUBinder::resetStats() -> void { stats_ = {}; }
+
 auto GPUBinder::convertTextureType(const TextureType type) const -> uint32_t
 {
     switch (type)
@@ -357,6 +877,79 @@ auto GPUBinder::convertColorType(const ColorType type) const -> uint32_t
     return 0;
 }
 
+auto GPUBinder::convertInternalFormat(const ColorType type) const -> uint32_t
+{
+    /* Sized formats so the driver doesn't have to guess the storage. */
+    switch (type)
+    {
+        case ColorType::MONO:
+            return GL_R8;
+        case ColorType::RGBA:
+            return GL_RGBA8;
+        case ColorType::RGB:
+            return GL_RGB8;
+    }
+
+    log_.error("Unknown type fed to texture! '{}'", static_cast<uint8_t>(type));
+    return 0;
+}
+
+auto GPUBinder::convertTextureWrap(const TextureWrap wrap) const -> uint32_t
+{
+    switch (wrap)
+    {
+        case TextureWrap::CLAMP_TO_EDGE:
+            return GL_CLAMP_TO_EDGE;
+        case TextureWrap::REPEAT:
+            return GL_REPEAT;
+        case TextureWrap::MIRRORED_REPEAT:
+            return GL_MIRRORED_REPEAT;
+    }
+
+    log_.error("Unknown texture wrap! '{}'", static_cast<uint8_t>(wrap));
+    return GL_CLAMP_TO_EDGE;
+}
+
+auto GPUBinder::convertTextureFilter(const TextureFilter filter) const -> uint32_t
+{
+    switch (filter)
+    {
+        case TextureFilter::NEAREST:
+            return GL_NEAREST;
+        case TextureFilter::LINEAR:
+            return GL_LINEAR;
+        case TextureFilter::NEAREST_MIPMAP_NEAREST:
+            return GL_NEAREST_MIPMAP_NEAREST;
+        case TextureFilter::LINEAR_MIPMAP_NEAREST:
+            return GL_LINEAR_MIPMAP_NEAREST;
+        case TextureFilter::LINEAR_MIPMAP_LINEAR:
+            return GL_LINEAR_MIPMAP_LINEAR;
+    }
+
+    log_.error("Unknown texture filter! '{}'", static_cast<uint8_t>(filter));
+    return GL_LINEAR;
+}
+
+auto GPUBinder::convertCompressedFormat(const CompressedFormat format) const -> uint32_t
+{
+    switch (format)
+    {
+        case CompressedFormat::BC1:
+            return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case CompressedFormat::BC3:
+            return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case CompressedFormat::BC7:
+            return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        case CompressedFormat::ETC2_RGB:
+            return GL_COMPRESSED_RGB8_ETC2;
+        case CompressedFormat::ETC2_RGBA:
+            return GL_COMPRESSED_RGBA8_ETC2_EAC;
+    }
+
+    log_.error("Unknown compressed format! '{}'", static_cast<uint8_t>(format));
+    return 0;
+}
+
 auto GPUBinder::convertShaderPartType(const ShaderPartType type) const -> uint32_t
 {
     switch (type)
@@ -422,7 +1015,15 @@ auto GPUBinder::isStausOk(const uint32_t idToQuerry, const ShaderStatusQuerry ty
 
 auto GPUBinder::useVao(const uint32_t vao) const -> void
 {
+    if (renderState_.vao == vao)
+    {
+        ++stats_.redundantCallsSkipped;
+        return;
+    }
+    renderState_.vao = vao;
+
     glBindVertexArray(vao);
+    ++stats_.glCalls;
 }
 
 auto GPUBinder::loadMeshData(const std::vector<float> eboData,
@@ -434,7 +1035,7 @@ auto GPUBinder::loadMeshData(const std::vector<float> eboData,
     /* Generate vertex attribute object to encapsulate the data */
     uint32_t vaoId;
     glCreateVertexArrays(1, &vaoId);
-    glBindVertexArray(vaoId);
+    useVao(vaoId);
 
     /* Generate buffer to hold vertex and index data */
     uint32_t vboId;
@@ -459,11 +1060,63 @@ auto GPUBinder::loadMeshData(const std::vector<float> eboData,
     return vaoId;
 }
 
-template auto GPUBinder::uploadUniform(const uint32_t, const std::string&, const glm::mat4&) const -> bool;
-template auto GPUBinder::uploadUniform(const uint32_t, const std::string&, const std::vector<glm::mat4>&) const -> bool;
-template auto GPUBinder::uploadUniform(const uint32_t, const std::string&, const glm::vec2&) const -> bool;
-template auto GPUBinder::uploadUniform(const uint32_t, const std::string&, const glm::vec4&) const -> bool;
-template auto GPUBinder::uploadUniform(const uint32_t, const std::string&, const int32_t&) const -> bool;
-template auto GPUBinder::uploadUniform(const uint32_t, const std::string&, const uint32_t&) const -> bool;
-template auto GPUBinder::uploadUniform(const uint32_t, const std::string&, const std::vector<int32_t>&) const -> bool;
+auto GPUBinder::attachInstanceBuffer(const uint32_t vao, const uint32_t bufferId, const uint32_t startLocation,
+    const std::vector<uint32_t>& componentsSize) const -> void
+{
+    const uint32_t stride = std::accumulate(componentsSize.begin(), componentsSize.end(), 0);
+
+    useVao(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, bufferId);
+
+    /* Same as for the vertex data but these attributes advance once per instance, not per vertex. */
+    uint64_t previousComponentSize{0};
+    for (uint32_t compIndex = 0; compIndex < componentsSize.size(); ++compIndex)
+    {
+        const uint32_t location = startLocation + compIndex;
+        glVertexAttribPointer(location, componentsSize[compIndex],
+            GL_FLOAT, GL_FALSE, stride * sizeof(float), (void*)(previousComponentSize * sizeof(float)));
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+        previousComponentSize += componentsSize[compIndex];
+    }
+
+    useVao(0);
+}
+
+auto GPUBinder::createBuffer() const -> uint32_t
+{
+    uint32_t bufferId;
+    glGenBuffers(1, &bufferId);
+    return bufferId;
+}
+
+auto GPUBinder::bufferInstanceData(const uint32_t bufferId, const void* data, const uint64_t bytes,
+    uint64_t& capacity) const -> void
+{
+    glBindBuffer(GL_ARRAY_BUFFER, bufferId);
+
+    /* Grow geometrically so a few more instances don't cause a reallocation each frame. The old storage
+        is always orphaned so the driver doesn't need to wait for the previous frame to finish with it. */
+    if (bytes > capacity) { capacity = std::max(bytes, capacity * 2); }
+
+    glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, data);
+    stats_.glCalls += 3;
+}
+
+template auto GPUBinder::uploadUniform(const uint32_t, const std::string_view, const glm::mat4&) const -> bool;
+template auto GPUBinder::uploadUniform(const uint32_t, const std::string_view, const std::vector<glm::mat4>&) const -> bool;
+template auto GPUBinder::uploadUniform(const uint32_t, const std::string_view, const glm::vec2&) const -> bool;
+template auto GPUBinder::uploadUniform(const uint32_t, const std::string_view, const glm::vec4&) const -> bool;
+template auto GPUBinder::uploadUniform(const uint32_t, const std::string_view, const int32_t&) const -> bool;
+template auto GPUBinder::uploadUniform(const uint32_t, const std::string_view, const uint32_t&) const -> bool;
+template auto GPUBinder::uploadUniform(const uint32_t, const std::string_view, const std::vector<int32_t>&) const -> bool;
+template auto GPUBinder::uploadUniform(const int32_t, const glm::mat4&) const -> bool;
+template auto GPUBinder::uploadUniform(const int32_t, const std::vector<glm::mat4>&) const -> bool;
+template auto GPUBinder::uploadUniform(const int32_t, const glm::vec2&) const -> bool;
+template auto GPUBinder::uploadUniform(const int32_t, const glm::vec4&) const -> bool;
+template auto GPUBinder::uploadUniform(const int32_t, const std::vector<glm::vec4>&) const -> bool;
+template auto GPUBinder::uploadUniform(const int32_t, const int32_t&) const -> bool;
+template auto GPUBinder::uploadUniform(const int32_t, const uint32_t&) const -> bool;
+template auto GPUBinder::uploadUniform(const int32_t, const std::vector<int32_t>&) const -> bool;
 } // namespace lav::core
\ No newline at end of file
@@ -1,6 +1,14 @@
 #pragma once
 
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+
 #include "src/Utils/Logger.hpp"
+#include "src/Utils/Misc.hpp"
 #include "vendor/glm/glm.hpp"
 
 namespace lav::core
@@ -23,9 +31,17 @@ public:
 
     enum class ColorType { MONO, RGB, RGBA};
 
-    enum class TextureWrap { CLAMP_TO_EDGE };
+    enum class TextureWrap { CLAMP_TO_EDGE, REPEAT, MIRRORED_REPEAT };
 
-    enum class TextureFilter { LINEAR };
+    /* Mipmap variants only make sense for minification. */
+    enum class TextureFilter
+    {
+        NEAREST,
+        LINEAR,
+        NEAREST_MIPMAP_NEAREST,
+        LINEAR_MIPMAP_NEAREST,
+        LINEAR_MIPMAP_LINEAR /* Trilinear */
+    };
 
     struct TextureOptions
     {
@@ -33,10 +49,74 @@ public:
         TextureWrap vWrap{TextureWrap::CLAMP_TO_EDGE};
         TextureFilter min{TextureFilter::LINEAR};
         TextureFilter mag{TextureFilter::LINEAR};
+        bool generateMipmaps{false}; /* Without mipmaps only the base level is sampled, whatever the filter */
+        float anisotropy{1.0f};      /* Clamped to what the driver supports. 1 means disabled */
+    };
+
+    /* Block compressed formats that can be uploaded as is. */
+    enum class CompressedFormat
+    {
+        BC1,      /* RGB + 1 bit alpha, 8 bytes per 4x4 block */
+        BC3,      /* RGBA, 16 bytes per 4x4 block */
+        BC7,      /* RGBA, 16 bytes per 4x4 block */
+        ETC2_RGB, /* RGB, 8 bytes per 4x4 block */
+        ETC2_RGBA /* RGBA, 16 bytes per 4x4 block */
     };
 
     enum class ShaderPartType { VERTEX, FRAG };
 
+    /** @brief Offscreen render target with a color texture and a depth renderbuffer. */
+    struct Framebuffer
+    {
+        uint32_t id{0};
+        uint32_t colorTexId{0};
+        uint32_t depthRbId{0};
+        glm::ivec2 size{0, 0};
+    };
+
+    /** @brief Asynchronous read back of framebuffer pixels through a pixel buffer. Reusable across reads. */
+    struct Readback
+    {
+        uint32_t bufferId{0};
+        uint64_t capacity{0};
+        void* fence{nullptr};  /* Signaled once the copy into the buffer is done */
+        glm::ivec2 size{0, 0};
+    };
+
+    /** @brief Counters of the GL calls issued since the last reset. Meant to be sampled once per frame. */
+    struct Stats
+    {
+        uint32_t glCalls{0};
+        uint32_t drawCalls{0};
+        uint32_t uniformUploads{0};
+        uint32_t locationQueries{0};
+        uint32_t redundantCallsSkipped{0}; /* Binds/toggles elided because the state was already set */
+    };
+
+#ifdef LAV_HEADLESS
+    /** @brief Command received by the headless backend. Kept in order of issue. */
+    struct Command
+    {
+        enum class Type : uint8_t
+        {
+            CLEAR,
+            DRAW,           /* id: VAO, amount: instances */
+            USE_PROGRAM,    /* id: program */
+            UNIFORM,        /* id: location, amount: bytes */
+            TEXTURE_CREATE, /* id: texture, amount: bytes */
+            TEXTURE_UPLOAD, /* id: texture, amount: bytes */
+            TEXTURE_DELETE, /* id: texture */
+            BUFFER_UPLOAD,  /* id: buffer, amount: bytes */
+            FRAMEBUFFER,    /* id: framebuffer bound, 0 for the screen */
+            READBACK        /* id: framebuffer read, amount: bytes */
+        };
+
+        Type type{Type::CLEAR};
+        uint32_t id{0};
+        uint64_t amount{0};
+    };
+#endif
+
 private:
     enum class ShaderStatusQuerry { COMPILE, LINK };
 
@@ -52,18 +132,50 @@ public:
     auto clearColor(const glm::vec4& color) -> void;
     auto clearAllBufferBits() -> void;
     auto renderBoundQuad() const -> void;
-    auto renderBoundQuadInstanced(const uint32_t size) const -> void;
+    auto renderBoundQuadInstanced(const uint32_t size, const uint32_t baseInstance = 0) const -> void;
 
     /* Shader */
     auto createProgram() const -> uint32_t;
     auto loadShaderPartType(const ShaderPartType type, const std::string& data) const -> uint32_t;
+    auto compileShaderPart(const ShaderPartType type, const std::string& data) const -> uint32_t;
+    auto deleteShaderPart(const uint32_t partId) const -> void;
     auto linkPartsToProgram(const uint32_t programId, const uint32_t vertexId, const uint32_t fragId) -> bool;
+    auto linkParts(const uint32_t programId, const uint32_t vertexId, const uint32_t fragId) const -> void;
+    auto isProgramLinked(const uint32_t programId) const -> bool;
+
+    /**
+        @brief Fetch the driver specific binary of a linked program.
+
+        @param programId Program to fetch
+        @param format Receives the driver's binary format
+
+        @return Binary blob or empty if binaries are not supported.
+    */
+    auto getProgramBinary(const uint32_t programId, uint32_t& format) const -> std::vector<uint8_t>;
+
+    /**
+        @brief Load a program from a blob previously returned by @ref `getProgramBinary`.
+
+        @note Drivers are free to reject old blobs (driver update, different GPU). That's not an error,
+            the caller is expected to compile from source instead.
+
+        @return True if the program is usable.
+    */
+    auto loadProgramBinary(const uint32_t programId, const uint32_t format,
+        const std::vector<uint8_t>& data) const -> bool;
+    auto isProgramBinarySupported() const -> bool;
+    auto getDriverString() const -> std::string;
     auto useProgram(const uint32_t programId) const -> void;
+    auto deleteProgram(const uint32_t programId) const -> void;
     template<typename T>
-    auto uploadUniform(const uint32_t programId, const std::string& name, const T& val) const -> bool;
-    auto uploadUniformTexture(const uint32_t programId, const std::string& name, const TextureType type,
+    auto uploadUniform(const uint32_t programId, const std::string_view name, const T& val) const -> bool;
+    template<typename T>
+    auto uploadUniform(const int32_t location, const T& val) const -> bool;
+    auto uploadUniformTexture(const uint32_t programId, const std::string_view name, const TextureType type,
         const uint32_t texSlot, const uint32_t texId) const -> bool;
-    auto getUniformLocation(const uint32_t programId, const std::string& name) const -> int32_t;
+    auto uploadUniformTexture(const int32_t location, const TextureType type, const uint32_t texSlot,
+        const uint32_t texId) const -> bool;
+    auto getUniformLocation(const uint32_t programId, const std::string_view name) const -> int32_t;
 
     /* Textures */
     auto generateTexture() const -> uint32_t;
@@ -74,6 +186,26 @@ public:
         unsigned char* data) const -> uint32_t;
     auto bufferTextureData(const uint32_t width, const uint32_t height, const uint32_t sliceCount,
         const TextureType texType, const ColorType colType, unsigned char* data) -> void;
+    auto bufferTextureSubData(const glm::ivec4& region, const uint32_t slice, const uint32_t rowLength,
+        const TextureType texType, const ColorType colType, const unsigned char* data) const -> void;
+    auto bufferTextureRegion(const glm::ivec4& region, const uint32_t slice, const TextureType texType,
+        const ColorType colType, const unsigned char* data) const -> void;
+    auto generateMipmaps(const TextureType texType, const uint32_t texId) const -> void;
+
+    /**
+        @brief Create a texture from block compressed data.
+
+        @param size Size of the base level
+        @param format Format of the blocks
+        @param levels Data of each mip level, base level first
+        @param texOpts Sampling options. Mipmaps are never generated, only the given levels are used
+
+        @return Texture id or zero if the format is not supported.
+    */
+    auto createCompressedTexture(const glm::ivec2& size, const CompressedFormat format,
+        const std::vector<std::vector<uint8_t>>& levels, const TextureOptions& texOpts) const -> uint32_t;
+    auto isCompressedFormatSupported(const CompressedFormat format) const -> bool;
+    auto deleteTexture(const uint32_t texId) const -> void;
     auto unpackAlignment(const uint32_t bytes = 1) const -> void;
 
     /* Meshes */
@@ -81,11 +213,86 @@ public:
     auto loadMeshData(const std::vector<float> eboData,
         const std::vector<uint32_t> indexData,
         const std::vector<uint32_t> eboComponentsSize) const -> uint32_t;
+    auto attachInstanceBuffer(const uint32_t vao, const uint32_t bufferId, const uint32_t startLocation,
+        const std::vector<uint32_t>& componentsSize) const -> void;
+
+    /* Buffers */
+    auto createBuffer() const -> uint32_t;
+    auto bufferInstanceData(const uint32_t bufferId, const void* data, const uint64_t bytes,
+        uint64_t& capacity) const -> void;
+
+    /* Framebuffers */
+    auto createFramebuffer(const glm::ivec2& size) const -> Framebuffer;
+    auto deleteFramebuffer(Framebuffer& framebuffer) const -> void;
+    auto bindFramebuffer(const uint32_t framebufferId) const -> void;
+    auto blitFramebufferToScreen(const Framebuffer& framebuffer) const -> void;
+
+    /**
+        @brief Start copying the pixels of a framebuffer. Returns right away, the GPU does the copy whenever
+            it gets to it.
+
+        @param readback Read back to start. A previous unfinished one is dropped
+        @param framebufferId Framebuffer to read, 0 for the window's back buffer
+        @param size Size of the area to read, from the bottom left corner
+    */
+    auto startReadback(Readback& readback, const uint32_t framebufferId, const glm::ivec2& size) const -> void;
+    auto isReadbackReady(const Readback& readback) const -> bool;
+
+    /**
+        @brief Fetch the pixels of a finished read back. Blocks if it's not ready yet.
+
+        @param readback Read back to finish
+        @param pixels Receives RGBA8 pixels, top row first
+
+        @return False if no read back was started.
+    */
+    auto finishReadback(Readback& readback, std::vector<uint8_t>& pixels) const -> bool;
+    auto deleteReadback(Readback& readback) const -> void;
+
+    /* Timer queries. Only one can be running at a time. */
+    auto createTimerQuery() const -> uint32_t;
+    auto deleteTimerQuery(uint32_t& queryId) const -> void;
+    auto beginTimerQuery(const uint32_t queryId) const -> void;
+    auto endTimerQuery() const -> void;
+
+    /**
+        @brief Fetch how long the GPU took to run the commands between begin and end. Never waits.
+
+        @param queryId Query to fetch
+
+        @return Elapsed nanoseconds or std::nullopt if the GPU didn't get there yet.
+    */
+    auto getTimerQueryResult(const uint32_t queryId) const -> std::optional<uint64_t>;
 
     auto convertTextureType(const TextureType type) const -> uint32_t;
     auto convertColorType(const ColorType type) const -> uint32_t;
+    auto convertInternalFormat(const ColorType type) const -> uint32_t;
+    auto convertTextureWrap(const TextureWrap wrap) const -> uint32_t;
+    auto convertTextureFilter(const TextureFilter filter) const -> uint32_t;
+    auto convertCompressedFormat(const CompressedFormat format) const -> uint32_t;
+    auto applyTextureOptions(const TextureType texType, const TextureOptions& texOpts,
+        const uint32_t mipLevels) const -> void;
+    auto getMaxAnisotropy() const -> float;
     auto getMaxTextureSlots() const -> uint32_t;
 
+    /**
+        @brief Forget the cached render state so the next bind/toggle of each kind reaches GL.
+
+        @note Needed only after GL state was changed without going through the binder.
+    */
+    auto invalidateRenderState() const -> void;
+
+    /* Statistics */
+    auto getStats() const -> const Stats&;
+    auto resetStats() -> void;
+
+#ifdef LAV_HEADLESS
+    /* Command log of the headless backend. Grows until cleared, disable recording for long runs. */
+    auto getCommands() const -> const std::vector<Command>&;
+    auto clearCommands() -> void;
+    auto setRecording(const bool record) -> void;
+#endif
+
 private:
     GPUBinder() = default;
     GPUBinder(const GPUBinder&) = delete;
@@ -96,8 +303,51 @@ private:
     auto convertShaderPartType(const ShaderPartType type) const -> uint32_t;
     auto convertShaderStatusQuerryType(const ShaderStatusQuerry type) const -> uint32_t;
     auto isStausOk(const uint32_t idToQuerry, const ShaderStatusQuerry type) const -> bool;
+    auto forgetTexture(const uint32_t texId) const -> void;
+#ifdef LAV_HEADLESS
+    auto record(const Command::Type type, const uint32_t id = 0, const uint64_t amount = 0) const -> void;
+    auto boundTexture(const TextureType texType) const -> uint32_t;
+#endif
 
 private:
+    /* Slots past this are never cached, binds on them always reach GL. */
+    static constexpr uint32_t MAX_TRACKED_SLOTS{32};
+    static constexpr uint32_t UNKNOWN{~0u};
+
+    /**
+        @brief State last set through the binder. All windows share one context so a single copy is enough.
+            UNKNOWN means the next call goes through whatever it asks for.
+    */
+    struct RenderState
+    {
+        uint32_t program;
+        uint32_t vao;
+        uint32_t activeSlot;
+        std::array<std::array<uint32_t, 2>, MAX_TRACKED_SLOTS> textures; /* Per slot, per TextureType */
+        std::array<uint32_t, 3> enabled;                                 /* Per Function. UNKNOWN, 0 or 1 */
+
+        RenderState() { invalidate(); }
+        auto invalidate() -> void
+        {
+            program = vao = activeSlot = UNKNOWN;
+            enabled.fill(UNKNOWN);
+            for (auto& slot : textures) { slot.fill(UNKNOWN); }
+        }
+    };
+
+    using LocationMap = std::unordered_map<std::string, int32_t, utils::StringHash, std::equal_to<>>;
+
     utils::Logger log_{"GPUBinder"};
+    mutable std::unordered_map<uint32_t, LocationMap> uniformLocations_;
+    mutable int32_t maxTextureSlots_{-1};
+    mutable float maxAnisotropy_{-1.0f};
+    mutable int32_t programBinaryFormats_{-1};
+    mutable Stats stats_;
+    mutable RenderState renderState_;
+#ifdef LAV_HEADLESS
+    mutable std::vector<Command> commands_;
+    mutable uint32_t lastObjectId_{0};
+    bool isRecording_{true};
+#endif
 };
 } // namespace lav::core
\ No newline at end of file
@@ -0,0 +1,525 @@
+#include "GPUBinder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+/* GPU backend used by LAV_HEADLESS builds. Nothing reaches a GPU: objects get made up ids and every command
+    is appended to an inspectable log instead. Binding, caching and statistics behave like the GL backend
+    so counters taken headless are comparable. */
+
+namespace lav::core
+{
+namespace
+{
+auto bytesPerPixel(const GPUBinder::ColorType type) -> uint64_t
+{
+    switch (type)
+    {
+        case GPUBinder::ColorType::MONO:
+            return 1;
+        case GPUBinder::ColorType::RGB:
+            return 3;
+        case GPUBinder::ColorType::RGBA:
+            return 4;
+    }
+    return 4;
+}
+} // namespace
+
+auto GPUBinder::get() -> GPUBinder&
+{
+    static GPUBinder instance;
+    return instance;
+}
+
+auto GPUBinder::init() -> bool
+{
+    log_.debug("Running headless, GPU commands are only recorded.");
+
+    enable(Function::DEPTH);
+    enable(Function::SCISSORS);
+    enable(Function::BLENDING);
+
+    return true;
+}
+
+auto GPUBinder::setViewportArea(const glm::ivec4&) -> void { ++stats_.glCalls; }
+
+auto GPUBinder::setScissorsArea(const glm::ivec4&) -> void { ++stats_.glCalls; }
+
+auto GPUBinder::clearColor(const glm::vec4&) -> void { ++stats_.glCalls; }
+
+auto GPUBinder::clearAllBufferBits() -> void
+{
+    ++stats_.glCalls;
+    record(Command::Type::CLEAR);
+}
+
+auto GPUBinder::enable(const Function func, const bool enable) -> void
+{
+    auto& enabled = renderState_.enabled[static_cast<uint8_t>(func)];
+    if (enabled == static_cast<uint32_t>(enable))
+    {
+        ++stats_.redundantCallsSkipped;
+        return;
+    }
+    enabled = enable;
+    ++stats_.glCalls;
+}
+
+auto GPUBinder::renderBoundQuad() const -> void
+{
+    ++stats_.glCalls;
+    ++stats_.drawCalls;
+    record(Command::Type::DRAW, renderState_.vao, 1);
+}
+
+auto GPUBinder::renderBoundQuadInstanced(const uint32_t size, const uint32_t) const -> void
+{
+    ++stats_.glCalls;
+    ++stats_.drawCalls;
+    record(Command::Type::DRAW, renderState_.vao, size);
+}
+
+auto GPUBinder::generateTexture() const -> uint32_t { return ++lastObjectId_; }
+
+auto GPUBinder::activateTextureSlot(const uint8_t textureSlot) const -> void
+{
+    const uint8_t maxSlots = getMaxTextureSlots();
+    if (textureSlot + 1 > maxSlots)
+    {
+        log_.warn("Max slots is '{}' but tried to activate slot '{}'", maxSlots, textureSlot);
+        return;
+    }
+
+    if (renderState_.activeSlot == textureSlot)
+    {
+        ++stats_.redundantCallsSkipped;
+        return;
+    }
+    renderState_.activeSlot = textureSlot;
+    ++stats_.glCalls;
+}
+
+auto GPUBinder::bindIdToTextureType(const TextureType texType, const uint32_t texId) const -> void
+{
+    const uint32_t slot = renderState_.activeSlot;
+    if (slot < MAX_TRACKED_SLOTS)
+    {
+        auto& boundId = renderState_.textures[slot][static_cast<uint8_t>(texType)];
+        if (boundId == texId)
+        {
+            ++stats_.redundantCallsSkipped;
+            return;
+        }
+        boundId = texId;
+    }
+    ++stats_.glCalls;
+}
+
+auto GPUBinder::createTexture(const uint32_t width, const uint32_t height, const uint32_t sliceCount,
+    const TextureType texType, const ColorType colType, const TextureOptions texOpts,
+    unsigned char* data) const -> uint32_t
+{
+    uint32_t id{generateTexture()};
+    activateTextureSlot(0);
+    bindIdToTextureType(texType, id);
+
+    const uint32_t mipLevels = texOpts.generateMipmaps
+        ? static_cast<uint32_t>(std::log2(std::max({width, height, 1u}))) + 1
+        : 1;
+    applyTextureOptions(texType, texOpts, mipLevels);
+
+    ++stats_.glCalls;
+    const uint32_t slices = texType == TextureType::Array2D ? sliceCount : 1;
+    const uint64_t bytes = uint64_t{width} * height * slices * bytesPerPixel(colType);
+    record(Command::Type::TEXTURE_CREATE, id, bytes);
+    if (data) { record(Command::Type::TEXTURE_UPLOAD, id, bytes); }
+
+    bindIdToTextureType(texType, 0);
+    return id;
+}
+
+auto GPUBinder::generateMipmaps(const TextureType texType, const uint32_t texId) const -> void
+{
+    bindIdToTextureType(texType, texId);
+    ++stats_.glCalls;
+    bindIdToTextureType(texType, 0);
+}
+
+auto GPUBinder::createCompressedTexture(const glm::ivec2&, const CompressedFormat format,
+    const std::vector<std::vector<uint8_t>>& levels, const TextureOptions& texOpts) const -> uint32_t
+{
+    if (levels.empty() || !isCompressedFormatSupported(format)) { return 0; }
+
+    uint32_t id{generateTexture()};
+    activateTextureSlot(0);
+    bindIdToTextureType(TextureType::Single2D, id);
+    applyTextureOptions(TextureType::Single2D, texOpts, levels.size());
+
+    uint64_t bytes{0};
+    for (const auto& level : levels) { bytes += level.size(); }
+    stats_.glCalls += levels.size();
+    record(Command::Type::TEXTURE_CREATE, id, bytes);
+    record(Command::Type::TEXTURE_UPLOAD, id, bytes);
+
+    bindIdToTextureType(TextureType::Single2D, 0);
+    return id;
+}
+
+auto GPUBinder::isCompressedFormatSupported(const CompressedFormat) const -> bool { return true; }
+
+auto GPUBinder::applyTextureOptions(const TextureType, const TextureOptions& texOpts, const uint32_t) const -> void
+{
+    stats_.glCalls += 5;
+    if (std::min(texOpts.anisotropy, getMaxAnisotropy()) > 1.0f) { ++stats_.glCalls; }
+}
+
+auto GPUBinder::getMaxAnisotropy() const -> float
+{
+    /* Same as most desktop drivers. */
+    return 16.0f;
+}
+
+auto GPUBinder::bufferTextureData(const uint32_t width, const uint32_t height, const uint32_t,
+    const TextureType texType, const ColorType colType, unsigned char*) -> void
+{
+    if (texType == GPUBinder::TextureType::Single2D)
+    {
+        log_.error("Not implemented Single2D yet {}", __func__);
+        return;
+    }
+    ++stats_.glCalls;
+    record(Command::Type::TEXTURE_UPLOAD, boundTexture(texType), uint64_t{width} * height * bytesPerPixel(colType));
+}
+
+auto GPUBinder::bufferTextureSubData(const glm::ivec4& region, const uint32_t, const uint32_t,
+    const TextureType texType, const ColorType colType, const unsigned char*) const -> void
+{
+    stats_.glCalls += 7;
+    record(Command::Type::TEXTURE_UPLOAD, boundTexture(texType),
+        uint64_t(region.z) * region.w * bytesPerPixel(colType));
+}
+
+auto GPUBinder::bufferTextureRegion(const glm::ivec4& region, const uint32_t, const TextureType texType,
+    const ColorType colType, const unsigned char*) const -> void
+{
+    ++stats_.glCalls;
+    record(Command::Type::TEXTURE_UPLOAD, boundTexture(texType),
+        uint64_t(region.z) * region.w * bytesPerPixel(colType));
+}
+
+auto GPUBinder::deleteTexture(const uint32_t texId) const -> void
+{
+    if (!texId) { return; }
+    ++stats_.glCalls;
+    forgetTexture(texId);
+    record(Command::Type::TEXTURE_DELETE, texId);
+}
+
+auto GPUBinder::unpackAlignment(const uint32_t) const -> void {}
+
+auto GPUBinder::createProgram() const -> uint32_t { return ++lastObjectId_; }
+
+auto GPUBinder::loadShaderPartType(const ShaderPartType type, const std::string& data) const -> uint32_t
+{
+    return compileShaderPart(type, data);
+}
+
+auto GPUBinder::compileShaderPart(const ShaderPartType, const std::string&) const -> uint32_t
+{
+    return ++lastObjectId_;
+}
+
+auto GPUBinder::deleteShaderPart(const uint32_t) const -> void {}
+
+auto GPUBinder::linkPartsToProgram(const uint32_t programId, const uint32_t vertexId, const uint32_t fragId) -> bool
+{
+    linkParts(programId, vertexId, fragId);
+    return isProgramLinked(programId);
+}
+
+auto GPUBinder::linkParts(const uint32_t, const uint32_t, const uint32_t) const -> void {}
+
+auto GPUBinder::isProgramLinked(const uint32_t programId) const -> bool { return programId; }
+
+auto GPUBinder::deleteProgram(const uint32_t programId) const -> void
+{
+    uniformLocations_.erase(programId);
+    if (renderState_.program == programId) { renderState_.program = UNKNOWN; }
+}
+
+auto GPUBinder::getProgramBinary(const uint32_t, uint32_t&) const -> std::vector<uint8_t> { return {}; }
+
+auto GPUBinder::loadProgramBinary(const uint32_t, const uint32_t, const std::vector<uint8_t>&) const -> bool
+{
+    return false;
+}
+
+auto GPUBinder::isProgramBinarySupported() const -> bool { return false; }
+
+auto GPUBinder::getDriverString() const -> std::string { return "headless"; }
+
+auto GPUBinder::useProgram(const uint32_t programId) const -> void
+{
+    if (renderState_.program == programId)
+    {
+        ++stats_.redundantCallsSkipped;
+        return;
+    }
+    renderState_.program = programId;
+    ++stats_.glCalls;
+    record(Command::Type::USE_PROGRAM, programId);
+}
+
+template<typename T>
+auto GPUBinder::uploadUniform(const uint32_t programId, const std::string_view name, const T& val) const -> bool
+{
+    return uploadUniform(getUniformLocation(programId, name), val);
+}
+
+template<typename T>
+auto GPUBinder::uploadUniform(const int32_t location, const T& val) const -> bool
+{
+    if (location == -1) { return false; }
+
+    uint64_t bytes{sizeof(T)};
+    if constexpr (requires { val.size(); typename T::value_type; })
+    {
+        bytes = val.size() * sizeof(typename T::value_type);
+    }
+
+    ++stats_.glCalls;
+    ++stats_.uniformUploads;
+    record(Command::Type::UNIFORM, location, bytes);
+    return true;
+}
+
+auto GPUBinder::uploadUniformTexture(const uint32_t programId, const std::string_view name, const TextureType type,
+        const uint32_t texSlot, const uint32_t texId) const -> bool
+{
+    return uploadUniformTexture(getUniformLocation(programId, name), type, texSlot, texId);
+}
+
+auto GPUBinder::uploadUniformTexture(const int32_t location, const TextureType type, const uint32_t texSlot,
+    const uint32_t texId) const -> bool
+{
+    const auto maxSlots = getMaxTextureSlots();
+    if (texSlot + 1 > maxSlots)
+    {
+        log_.error(
+            "GPU not able to support more than {} texture slots. Tried to use slot {}", maxSlots, texSlot);
+        return false;
+    }
+
+    if (!uploadUniform(location, texSlot)) { return false; }
+
+    activateTextureSlot(texSlot);
+    bindIdToTextureType(type, texId);
+    return true;
+}
+
+auto GPUBinder::getMaxTextureSlots() const -> uint32_t
+{
+    /* Minimum the GL 4 spec guarantees. */
+    return 16;
+}
+
+auto GPUBinder::getUniformLocation(const uint32_t programId, const std::string_view name) const -> int32_t
+{
+    /* Programs have no real uniforms, any name gets the next free location of its program. */
+    auto& programLocations = uniformLocations_[programId];
+    if (const auto it = programLocations.find(name); it != programLocations.end())
+    {
+        return it->second;
+    }
+
+    const int32_t location = programLocations.size();
+    ++stats_.glCalls;
+    ++stats_.locationQueries;
+
+    programLocations.emplace(std::string{name}, location);
+    return location;
+}
+
+auto GPUBinder::useVao(const uint32_t vao) const -> void
+{
+    if (renderState_.vao == vao)
+    {
+        ++stats_.redundantCallsSkipped;
+        return;
+    }
+    renderState_.vao = vao;
+    ++stats_.glCalls;
+}
+
+auto GPUBinder::loadMeshData(const std::vector<float>, const std::vector<uint32_t>,
+    const std::vector<uint32_t>) const -> uint32_t
+{
+    const uint32_t vaoId{++lastObjectId_};
+    useVao(vaoId);
+    return vaoId;
+}
+
+auto GPUBinder::attachInstanceBuffer(const uint32_t vao, const uint32_t, const uint32_t,
+    const std::vector<uint32_t>&) const -> void
+{
+    useVao(vao);
+    useVao(0);
+}
+
+auto GPUBinder::createBuffer() const -> uint32_t { return ++lastObjectId_; }
+
+auto GPUBinder::bufferInstanceData(const uint32_t bufferId, const void*, const uint64_t bytes,
+    uint64_t& capacity) const -> void
+{
+    if (bytes > capacity) { capacity = std::max(bytes, capacity * 2); }
+    stats_.glCalls += 3;
+    record(Command::Type::BUFFER_UPLOAD, bufferId, bytes);
+}
+
+auto GPUBinder::createFramebuffer(const glm::ivec2& size) const -> Framebuffer
+{
+    Framebuffer framebuffer{.size = size};
+    framebuffer.id = ++lastObjectId_;
+    framebuffer.colorTexId = ++lastObjectId_;
+    framebuffer.depthRbId = ++lastObjectId_;
+    record(Command::Type::TEXTURE_CREATE, framebuffer.colorTexId, uint64_t(size.x) * size.y * 4);
+    return framebuffer;
+}
+
+auto GPUBinder::deleteFramebuffer(Framebuffer& framebuffer) const -> void
+{
+    if (!framebuffer.id) { return; }
+
+    forgetTexture(framebuffer.colorTexId);
+    record(Command::Type::TEXTURE_DELETE, framebuffer.colorTexId);
+    framebuffer = {};
+}
+
+auto GPUBinder::bindFramebuffer(const uint32_t framebufferId) const -> void
+{
+    ++stats_.glCalls;
+    record(Command::Type::FRAMEBUFFER, framebufferId);
+}
+
+auto GPUBinder::blitFramebufferToScreen(const Framebuffer&) const -> void
+{
+    stats_.glCalls += 4;
+    record(Command::Type::FRAMEBUFFER, 0);
+}
+
+auto GPUBinder::startReadback(Readback& readback, const uint32_t framebufferId, const glm::ivec2& size) const -> void
+{
+    /* Any non null value, there's no real fence to wait on. */
+    if (!readback.bufferId) { readback.bufferId = ++lastObjectId_; }
+    readback.fence = &readback;
+    readback.size = size;
+    stats_.glCalls += 6;
+    record(Command::Type::READBACK, framebufferId, uint64_t(size.x) * size.y * 4);
+}
+
+auto GPUBinder::isReadbackReady(const Readback& readback) const -> bool { return readback.fence; }
+
+auto GPUBinder::finishReadback(Readback& readback, std::vector<uint8_t>& pixels) const -> bool
+{
+    if (!readback.fence) { return false; }
+    readback.fence = nullptr;
+
+    /* Nothing was ever drawn, hand out a transparent image of the right size. */
+    pixels.assign(uint64_t(readback.size.x) * readback.size.y * 4, 0);
+    return true;
+}
+
+auto GPUBinder::deleteReadback(Readback& readback) const -> void { readback = {}; }
+
+auto GPUBinder::createTimerQuery() const -> uint32_t { return ++lastObjectId_; }
+
+auto GPUBinder::deleteTimerQuery(uint32_t& queryId) const -> void { queryId = 0; }
+
+auto GPUBinder::beginTimerQuery(const uint32_t) const -> void {}
+
+auto GPUBinder::endTimerQuery() const -> void {}
+
+auto GPUBinder::getTimerQueryResult(const uint32_t) const -> std::optional<uint64_t>
+{
+    /* Nothing executes, there's no GPU time to report. */
+    return std::nullopt;
+}
+
+auto GPUBinder::convertTextureType(const TextureType type) const -> uint32_t
+{
+    return static_cast<uint32_t>(type) + 1;
+}
+
+auto GPUBinder::convertColorType(const ColorType type) const -> uint32_t { return static_cast<uint32_t>(type) + 1; }
+
+auto GPUBinder::convertInternalFormat(const ColorType type) const -> uint32_t
+{
+    return static_cast<uint32_t>(type) + 1;
+}
+
+auto GPUBinder::convertTextureWrap(const TextureWrap wrap) const -> uint32_t
+{
+    return static_cast<uint32_t>(wrap) + 1;
+}
+
+auto GPUBinder::convertTextureFilter(const TextureFilter filter) const -> uint32_t
+{
+    return static_cast<uint32_t>(filter) + 1;
+}
+
+auto GPUBinder::convertCompressedFormat(const CompressedFormat format) const -> uint32_t
+{
+    return static_cast<uint32_t>(format) + 1;
+}
+
+auto GPUBinder::invalidateRenderState() const -> void { renderState_.invalidate(); }
+
+auto GPUBinder::forgetTexture(const uint32_t texId) const -> void
+{
+    for (auto& slot : renderState_.textures)
+    {
+        std::ranges::replace(slot, texId, 0u);
+    }
+}
+
+auto GPUBinder::getStats() const -> const Stats& { return stats_; }
+
+auto GPUBinder::resetStats() -> void { stats_ = {}; }
+
+auto GPUBinder::getCommands() const -> const std::vector<Command>& { return commands_; }
+
+auto GPUBinder::clearCommands() -> void { commands_.clear(); }
+
+auto GPUBinder::setRecording(const bool record) -> void { isRecording_ = record; }
+
+auto GPUBinder::record(const Command::Type type, const uint32_t id, const uint64_t amount) const -> void
+{
+    if (!isRecording_) { return; }
+    commands_.emplace_back(type, id, amount);
+}
+
+auto GPUBinder::boundTexture(const TextureType texType) const -> uint32_t
+{
+    const uint32_t slot = renderState_.activeSlot;
+    return slot < MAX_TRACKED_SLOTS ? renderState_.textures[slot][static_cast<uint8_t>(texType)] : UNKNOWN;
+}
+
+template auto GPUBinder::uploadUniform(const uint32_t, const std::string_view, const glm::mat4&) const -> bool;
+template auto GPUBinder::uploadUniform(const uint32_t, const std::string_view, const std::vector<glm::mat4>&) const -> bool;
+template auto GPUBinder::uploadUniform(const uint32_t, const std::string_view, const glm::vec2&) const -> bool;
+template auto GPUBinder::uploadUniform(const uint32_t, const std::string_view, const glm::vec4&) const -> bool;
+template auto GPUBinder::uploadUniform(const uint32_t, const std::string_view, const int32_t&) const -> bool;
+template auto GPUBinder::uploadUniform(const uint32_t, const std::string_view, const uint32_t&) const -> bool;
+template auto GPUBinder::uploadUniform(const uint32_t, const std::string_view, const std::vector<int32_t>&) const -> bool;
+template auto GPUBinder::uploadUniform(const int32_t, const glm::mat4&) const -> bool;
+template auto GPUBinder::uploadUniform(const int32_t, const std::vector<glm::mat4>&) const -> bool;
+template auto GPUBinder::uploadUniform(const int32_t, const glm::vec2&) const -> bool;
+template auto GPUBinder::uploadUniform(const int32_t, const glm::vec4&) const -> bool;
+template auto GPUBinder::uploadUniform(const int32_t, const std::vector<glm::vec4>&) const -> bool;
+template auto GPUBinder::uploadUniform(const int32_t, const int32_t&) const -> bool;
+template auto GPUBinder::uploadUniform(const int32_t, const uint32_t&) const -> bool;
+template auto GPUBinder::uploadUniform(const int32_t, const std::vector<int32_t>&) const -> bool;
+} // namespace lav::core
@@ -1,6 +1,8 @@
 #include "WindowBinder.hpp"
 #include "vendor/glfw/include/GLFW/glfw3.h"
 
+#include "src/Utils/Profiler.hpp"
+
 namespace lav::core
 {
 auto WindowBinder::get() -> WindowBinder&
@@ -9,7 +11,7 @@ auto WindowBinder::get() -> WindowBinder&
     return instance;
 }
 
-auto WindowBinder::init() -> bool
+auto WindowBinder::init(const bool offscreen) -> bool
 {
     glfwSetErrorCallback(
         [](int32_t error, const char* message)
@@ -17,7 +19,11 @@ auto WindowBinder::init() -> bool
             utils::Logger internalLog("WindowBinder");
             internalLog.error("{}: {}", error, message);
         });
-    
+
+    /* Null platform windows have no surface and need no display server. */
+    isOffscreen_ = offscreen;
+    if (isOffscreen_) { glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL); }
+
     if (!glfwInit())
     {
         log_.error("Couldn't initialize GLFW.");
@@ -29,15 +35,41 @@ auto WindowBinder::init() -> bool
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
     glfwWindowHint(GLFW_VISIBLE, false);
 
-    initWindowHandle_ = glfwCreateWindow(100, 100, "dummy", NULL, NULL);
+    if (isOffscreen_)
+    {
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+        initWindowHandle_ = glfwCreateWindow(100, 100, "dummy", NULL, NULL);
+        if (!initWindowHandle_)
+        {
+            log_.warn("No surfaceless EGL context, trying OSMesa..");
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+            initWindowHandle_ = glfwCreateWindow(100, 100, "dummy", NULL, NULL);
+        }
+
+        /* Everything renders with the init window's context. Windows only exist for their size and input. */
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+    }
+    else
+    {
+        initWindowHandle_ = glfwCreateWindow(100, 100, "dummy", NULL, NULL);
+        glfwWindowHint(GLFW_VISIBLE, true);
+    }
+
+    if (!initWindowHandle_)
+    {
+        log_.error("Couldn't create the main context.");
+        return false;
+    }
 
-    glfwWindowHint(GLFW_VISIBLE, true);
     glfwMakeContextCurrent(initWindowHandle_);
     enableVSync(true);
 
 #ifdef __linux__
-    initDisplay_ = glfwGetX11Display();
-    initContext_ = glXGetCurrentContext();
+    if (!isOffscreen_)
+    {
+        initDisplay_ = glfwGetX11Display();
+        initContext_ = glXGetCurrentContext();
+    }
 #endif
 
     cursors_[Cursor::ARROW] = glfwCreateStandardCursor(GLFW_ARROW_CURSOR);
@@ -63,6 +95,8 @@ auto WindowBinder::terminate() -> void
     log_.debug("Terminated.");
 }
 
+auto WindowBinder::isOffscreen() const -> bool { return isOffscreen_; }
+
 auto WindowBinder::createWindow(const std::string& title, const glm::ivec2 size) -> WindowHandle
 {
     WindowHandle windowHandle = glfwCreateWindow(size.x, size.y, title.c_str(), NULL, NULL);
@@ -82,6 +116,9 @@ auto WindowBinder::createWindow(const std::string& title, const glm::ivec2 size)
 
 auto WindowBinder::makeContextCurrent(WindowHandle handle) -> void
 {
+    /* Offscreen there is only the init window's context and it stays current. */
+    if (isOffscreen_) { return; }
+
 #ifdef __linux__
     glXMakeCurrent(initDisplay_, glfwGetX11Window(handle), initContext_);
 #else
@@ -91,6 +128,9 @@ auto WindowBinder::makeContextCurrent(WindowHandle handle) -> void
 
 auto WindowBinder::enableVSync(const bool enable) -> void
 {
+    /* Nothing is presented offscreen, frames shall run as fast as they can. */
+    if (isOffscreen_) { return; }
+
 #ifdef __linux__
     /* Unfortunately due to drivers or my limited knowledge we can only have the main window obey
     the vSync rule. As soon as there are 2 or more windows it looks like it doesn't want to apply anymore. */
@@ -123,6 +163,8 @@ auto WindowBinder::maskEvents(WindowHandle handle) -> void
        Not sure if the behavior is similar on Windows/MacOS. */
 
 #ifdef __linux__
+    if (isOffscreen_) { return; }
+
     XWindowAttributes attributes;
 
     XGetWindowAttributes(initDisplay_, glfwGetX11Window(handle), &attributes);
@@ -151,6 +193,11 @@ auto WindowBinder::destroyCursor(WindowCursor cursor) -> void
 
 auto WindowBinder::swapBuffers(WindowHandle handle) -> void
 {
+    LAV_PROFILE_ZONE("WindowBinder::swapBuffers");
+
+    /* No surface to present to. Frames stay in the windows' framebuffers. */
+    if (isOffscreen_) { return; }
+
     if (!glfwGetCurrentContext())
     {
         utils::Logger("WINDOW").error("No context is bound!");
@@ -178,13 +225,29 @@ auto WindowBinder::setTitle(WindowHandle handle, const std::string& title) -> vo
     glfwSetWindowTitle(handle, title.c_str());
 }
 
-auto WindowBinder::setPollWaitForEvents(const bool wait) -> void { pollingMethodIsWait_ = wait; }
-
 auto WindowBinder::pollEvents() -> void
 {
-    pollingMethodIsWait_ ? glfwWaitEvents() : glfwPollEvents();
+    LAV_PROFILE_ZONE("WindowBinder::pollEvents");
+
+    glfwPollEvents();
 }
 
+auto WindowBinder::waitEvents() -> void
+{
+    LAV_PROFILE_ZONE("WindowBinder::waitEvents");
+
+    glfwWaitEvents();
+}
+
+auto WindowBinder::waitEventsTimeout(const double timeout) -> void
+{
+    LAV_PROFILE_ZONE("WindowBinder::waitEvents");
+
+    glfwWaitEventsTimeout(timeout);
+}
+
+auto WindowBinder::postEmptyEvent() -> void { glfwPostEmptyEvent(); }
+
 auto WindowBinder::destroyWindow(WindowHandle handle) -> void
 {
     glfwDestroyWindow(handle);
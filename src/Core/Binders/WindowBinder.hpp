@@ -1,18 +1,29 @@
 #pragma once
 
-#include <string>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 
-#ifdef __linux__
-#include <GL/glx.h>
-#endif
-
+/* LAV_HEADLESS swaps the GLFW/X11 windowing (and the GL backend of GPUBinder) for stand-ins that need no
+    display or GPU. Selected at configure time, see the LAV_HEADLESS option in CMakeLists.txt. */
+#ifndef LAV_HEADLESS
 #define LAV_USE_GLFW_WINDOWING
+#endif
 
 #ifdef LAV_USE_GLFW_WINDOWING
+#ifdef __linux__
+#include <GL/glx.h>
+#endif
 #define GLFW_EXPOSE_NATIVE_X11
 #include "vendor/glfw/include/GLFW/glfw3.h"
 #include "vendor/glfw/include/GLFW/glfw3native.h"
+#else
+/* Only for the key/button/cursor values below so injected input matches real input. Nothing gets linked. */
+#define GLFW_INCLUDE_NONE
+#include "vendor/glfw/include/GLFW/glfw3.h"
 #endif
 
 #include "src/Utils/Logger.hpp"
@@ -28,6 +39,20 @@ namespace lav::core
 #ifdef LAV_USE_GLFW_WINDOWING
 using WindowHandle = GLFWwindow*;
 using WindowCursor = GLFWcursor*;
+#else
+/** @brief Stand-in for a native window. Only remembers what a real one would have been told. */
+struct HeadlessWindow
+{
+    std::string title;
+    glm::ivec2 size{0, 0};
+    void* userPointer{nullptr};
+    uint32_t cursor{0};
+    uint64_t swappedFrames{0};
+    bool shouldClose{false};
+};
+
+using WindowHandle = HeadlessWindow*;
+using WindowCursor = uint32_t;
 #endif
 
 using KeyCallback = std::function<void(int32_t key, int32_t scanCode, int32_t action, int32_t mods)>;
@@ -57,8 +82,18 @@ public:
 public:
     static auto get() -> WindowBinder&;
 
-    auto init() -> bool;
+    /**
+        @brief Initialize windowing and create the context shared by all windows.
+
+        @param offscreen Create windows with no surface at all, no display server needed. The context comes
+            from EGL (surfaceless) or OSMesa, whichever is available, and windows have to render into their
+            own framebuffers as there's nothing to present to.
+
+        @return True on success.
+    */
+    auto init(const bool offscreen = false) -> bool;
     auto terminate() -> void;
+    auto isOffscreen() const -> bool;
     auto createWindow(const std::string& title, const glm::ivec2 size) -> WindowHandle;
     auto makeContextCurrent(WindowHandle handle) -> void;
     auto enableVSync(const bool) -> void;
@@ -70,13 +105,33 @@ public:
     auto shouldWindowClose(WindowHandle handle) -> bool;
     auto close(WindowHandle handle) -> void;
     auto setTitle(WindowHandle handle, const std::string& title) -> void;
-    auto setPollWaitForEvents(const bool wait) -> void;
+
+    /* Event processing. Callbacks run from within these, on the calling thread. */
     auto pollEvents() -> void;
+    auto waitEvents() -> void;
+    auto waitEventsTimeout(const double timeout) -> void;
+
+    /** @brief Wake up a waitEvents*() call. Can be called from any thread. */
+    auto postEmptyEvent() -> void;
+
     auto getTime() -> double;
     auto destroyWindow(WindowHandle handle) -> void;
 
     auto setInputCallbacks(WindowHandle handle, const InputCallbacks& cbs) -> void;
 
+#ifdef LAV_HEADLESS
+    /* Input injection. Callbacks run right away, same as GLFW would run them from within pollEvents(). */
+    auto injectKey(WindowHandle handle, const int32_t key, const int32_t action, const int32_t mods = 0) -> void;
+    auto injectCharacter(WindowHandle handle, const uint32_t codepoint) -> void;
+    auto injectMouseMove(WindowHandle handle, const glm::ivec2& pos) -> void;
+    auto injectMouseButton(WindowHandle handle, const uint8_t btn, const uint8_t action) -> void;
+    auto injectMouseScroll(WindowHandle handle, const int8_t xOffset, const int8_t yOffset) -> void;
+    auto injectMouseEnter(WindowHandle handle, const bool entered) -> void;
+
+    /** @brief Resize the window and notify it, like a user dragging its border would. */
+    auto injectResize(WindowHandle handle, const glm::ivec2& size) -> void;
+#endif
+
 private:
     WindowBinder() = default;
     WindowBinder(const WindowBinder&) = delete;
@@ -88,12 +143,17 @@ private:
 
 private:
     utils::Logger log_{"WindowBinder"};
-    bool pollingMethodIsWait_{true};
-    std::unordered_map<lav::Cursor, GLFWcursor*> cursors_;
+    bool isOffscreen_{false};
+    std::unordered_map<lav::Cursor, WindowCursor> cursors_;
 
     WindowHandle initWindowHandle_{nullptr};
 
-#ifdef __linux__
+#ifdef LAV_HEADLESS
+    std::chrono::steady_clock::time_point startTime_;
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCv_;
+    bool isWakePending_{false};
+#elif defined(__linux__)
     /*
         In order for all windows to share a single context, and thus the same resources, we need
         to go native, beyond normal handling. All resources will be shared with the init
@@ -142,6 +202,7 @@ enum Key : uint32_t
 {
     ESC = GLFW_KEY_ESCAPE,
     C = GLFW_KEY_C,
-    P = GLFW_KEY_P
+    P = GLFW_KEY_P,
+    T = GLFW_KEY_T
 };
 }
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "WindowBinder.hpp"
+
+/* Windowing used by LAV_HEADLESS builds. Windows only exist in memory and input comes from the inject*
+    functions, so the whole UI stack can run on machines without a display. */
+
+namespace lav::core
+{
+auto WindowBinder::get() -> WindowBinder&
+{
+    static WindowBinder instance;
+    return instance;
+}
+
+auto WindowBinder::init(const bool) -> bool
+{
+    /* Headless windows are always offscreen. */
+    isOffscreen_ = true;
+    startTime_ = std::chrono::steady_clock::now();
+
+    /* Same as the GLFW one, the first "window" only exists to own the context. */
+    initWindowHandle_ = createWindow("dummy", {100, 100});
+
+    log_.debug("Running headless, no display or GPU will be used.");
+    return true;
+}
+
+auto WindowBinder::terminate() -> void
+{
+    destroyWindow(initWindowHandle_);
+    initWindowHandle_ = nullptr;
+    log_.debug("Terminated.");
+}
+
+auto WindowBinder::createWindow(const std::string& title, const glm::ivec2 size) -> WindowHandle
+{
+    /* Owned by whoever created it, same as a GLFW window it gets freed by destroyWindow(). */
+    WindowHandle windowHandle = new HeadlessWindow{.title = title, .size = size};
+
+    log_.info("Window '{}/{{{}, {}}}' has been created!", title, size.x, size.y);
+    return windowHandle;
+}
+
+auto WindowBinder::isOffscreen() const -> bool { return isOffscreen_; }
+
+auto WindowBinder::makeContextCurrent(WindowHandle) -> void {}
+
+auto WindowBinder::enableVSync(const bool) -> void {}
+
+auto WindowBinder::maskEvents(WindowHandle) -> void {}
+
+auto WindowBinder::setCursor(WindowHandle handle, WindowCursor cursor) -> void { handle->cursor = cursor; }
+
+auto WindowBinder::setStandardCursor(WindowHandle handle, lav::Cursor cursor) -> void
+{
+    setCursor(handle, cursor);
+}
+
+auto WindowBinder::destroyCursor(WindowCursor) -> void {}
+
+auto WindowBinder::swapBuffers(WindowHandle handle) -> void { ++handle->swappedFrames; }
+
+auto WindowBinder::shouldWindowClose(WindowHandle handle) -> bool { return handle->shouldClose; }
+
+auto WindowBinder::close(WindowHandle handle) -> void
+{
+    handle->shouldClose = true;
+    postEmptyEvent();
+}
+
+auto WindowBinder::setTitle(WindowHandle handle, const std::string& title) -> void { handle->title = title; }
+
+auto WindowBinder::pollEvents() -> void
+{
+    /* Injected input is already delivered. Only a pending wake up is left to consume. */
+    std::scoped_lock lock{wakeMutex_};
+    isWakePending_ = false;
+}
+
+auto WindowBinder::waitEvents() -> void
+{
+    /* Only injected input or postEmptyEvent() can end the wait, like real input would. */
+    std::unique_lock lock{wakeMutex_};
+    wakeCv_.wait(lock, [this] { return isWakePending_; });
+    isWakePending_ = false;
+}
+
+auto WindowBinder::waitEventsTimeout(const double timeout) -> void
+{
+    std::unique_lock lock{wakeMutex_};
+    wakeCv_.wait_for(lock, std::chrono::duration<double>(timeout), [this] { return isWakePending_; });
+    isWakePending_ = false;
+}
+
+auto WindowBinder::postEmptyEvent() -> void
+{
+    {
+        std::scoped_lock lock{wakeMutex_};
+        isWakePending_ = true;
+    }
+    wakeCv_.notify_one();
+}
+
+auto WindowBinder::destroyWindow(WindowHandle handle) -> void { delete handle; }
+
+auto WindowBinder::getTime() -> double
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime_).count();
+}
+
+auto WindowBinder::setUserPointer(WindowHandle handle, void* data) -> void { handle->userPointer = data; }
+
+auto WindowBinder::setInputCallbacks(WindowHandle handle, const InputCallbacks& cbs) -> void
+{
+    setUserPointer(handle, (void*)&cbs);
+}
+
+auto WindowBinder::injectKey(WindowHandle handle, const int32_t key, const int32_t action,
+    const int32_t mods) -> void
+{
+    if (!handle->userPointer) { return; }
+    static_cast<InputCallbacks*>(handle->userPointer)->keyCallback(key, 0, action, mods);
+    postEmptyEvent();
+}
+
+auto WindowBinder::injectCharacter(WindowHandle handle, const uint32_t codepoint) -> void
+{
+    if (!handle->userPointer) { return; }
+    static_cast<InputCallbacks*>(handle->userPointer)->characterCallback(codepoint);
+    postEmptyEvent();
+}
+
+auto WindowBinder::injectMouseMove(WindowHandle handle, const glm::ivec2& pos) -> void
+{
+    if (!handle->userPointer) { return; }
+    static_cast<InputCallbacks*>(handle->userPointer)->mouseMoveCallback(pos.x, pos.y);
+    postEmptyEvent();
+}
+
+auto WindowBinder::injectMouseButton(WindowHandle handle, const uint8_t btn, const uint8_t action) -> void
+{
+    if (!handle->userPointer) { return; }
+    static_cast<InputCallbacks*>(handle->userPointer)->mouseBtnCallback(btn, action);
+    postEmptyEvent();
+}
+
+auto WindowBinder::injectMouseScroll(WindowHandle handle, const int8_t xOffset, const int8_t yOffset) -> void
+{
+    if (!handle->userPointer) { return; }
+    static_cast<InputCallbacks*>(handle->userPointer)->mouseScrollCallback(xOffset, yOffset);
+    postEmptyEvent();
+}
+
+auto WindowBinder::injectMouseEnter(WindowHandle handle, const bool entered) -> void
+{
+    if (!handle->userPointer) { return; }
+    static_cast<InputCallbacks*>(handle->userPointer)->windowMouseEntered(entered);
+    postEmptyEvent();
+}
+
+auto WindowBinder::injectResize(WindowHandle handle, const glm::ivec2& size) -> void
+{
+    handle->size = size;
+    if (!handle->userPointer) { return; }
+    static_cast<InputCallbacks*>(handle->userPointer)->windowSizeCallback(size.x, size.y);
+    postEmptyEvent();
+}
+} // namespace lav::core
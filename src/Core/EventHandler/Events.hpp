@@ -1,17 +1,27 @@
 #pragma once
 
-#include <functional>
-#include <typeindex>
-#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <vector>
 
 #include "IEvent.hpp"
+#include "src/Utils/SmallFunction.hpp"
 
 namespace lav::core
 {
-using EventCallback = std::function<void(const IEvent&)>;
+using EventCallback = utils::SmallFunction<void(const IEvent&)>;
+
+/* Identifies a single listener. Zero is never handed out. */
+using ListenerHandle = uint32_t;
 
 /**
     @brief Manager handling the storage and dispatch of user or window generated events.
+
+    @note Listeners are kept in one small flat array and matched by event id on emit. Elements rarely
+        have more than a handful of them so a linear scan beats any hashing.
+    @note Callbacks are stored inline (no heap allocation) and invoked without any runtime type check
+        as the event id already tells the type.
 */
 class Events
 {
@@ -19,23 +29,72 @@ public:
     /**
         @brief Listen to a specific template event EventT and call the callback when it happens.
 
+        @note Adds to the existing listeners of EventT, it no longer replaces them. Calling it twice for the
+            same event means both callbacks run. Use subscribe() if a listener needs to be removed later.
+
         @param callback Callback to be called upon event triggered.
 
         @return Myself.
     */
-    template<typename EventT>
-    auto listenTo(const std::function<void(const EventT)>& callback) -> Events&
+    template<typename EventT, typename Callback>
+    auto listenTo(Callback&& callback) -> Events&
+    {
+        subscribe<EventT>(std::forward<Callback>(callback));
+        return *this;
+    }
+
+    /**
+        @brief Add a listener for a specific template event EventT.
+
+        @param callback Callback to be called upon event triggered.
+
+        @return Handle that can be used to unsubscribe the listener.
+    */
+    template<typename EventT, typename Callback>
+    auto subscribe(Callback&& callback) -> ListenerHandle
+    {
+        Listener listener{
+            .callback = [cb = std::forward<Callback>(callback)](const IEvent& e)
+                { cb(static_cast<const EventT&>(e)); },
+            .eventId = EventT::eventId,
+            .handle = ++lastHandle_};
+
+        /* Growing the array while emitting would move the callback that's currently running. */
+        emitDepth_ ? pending_.emplace_back(std::move(listener)) : listeners_.emplace_back(std::move(listener));
+        ++listenersVersion_;
+
+        return lastHandle_;
+    }
+
+    /**
+        @brief Remove a previously subscribed listener. Safe to call from inside a callback.
+
+        @param handle Handle returned by subscribe()
+
+        @return True if the listener was found.
+    */
+    auto unsubscribe(const ListenerHandle handle) -> bool
     {
-        const uint32_t key = std::type_index(typeid(EventT)).hash_code();
-        eventMap_[key] = [callback](const IEvent& e)
+        if (!handle) { return false; }
+
+        if (std::erase_if(pending_, [handle](const Listener& l) { return l.handle == handle; }))
         {
-            if (const auto eCast = dynamic_cast<const EventT*>(&e))
-            {
-                callback(*eCast);
-            }
-        };
+            return true;
+        }
 
-        return *this;
+        const auto it = std::ranges::find(listeners_, handle, &Listener::handle);
+        if (it == listeners_.end()) { return false; }
+
+        /* Only mark it while emitting, it gets compacted once we're done. */
+        if (emitDepth_)
+        {
+            it->handle = 0;
+            hasRemovals_ = true;
+        }
+        else { listeners_.erase(it); }
+        ++listenersVersion_;
+
+        return true;
     }
 
     /**
@@ -46,14 +105,57 @@ public:
     template<typename EventT>
     auto emitEvent(EventT& event) -> void
     {
-        const uint32_t key = std::type_index(typeid(EventT)).hash_code();
+        ++emitDepth_;
+        for (const auto& listener : listeners_)
+        {
+            if (listener.eventId == EventT::eventId && listener.handle) { listener.callback(event); }
+        }
+        --emitDepth_;
+
+        if (!emitDepth_ && (hasRemovals_ || !pending_.empty())) { settle(); }
+    }
+
+    /**
+        @brief Check if there's any listener for the given event.
 
-        if (!eventMap_.contains(key)) { return; }
+        @param eventId Id of the event to check
+
+        @return True if a callback is registered for it.
+    */
+    auto isListeningTo(const uint32_t eventId) const -> bool
+    {
+        const auto matches = [eventId](const Listener& l) { return l.eventId == eventId && l.handle; };
+        return std::ranges::any_of(listeners_, matches) || std::ranges::any_of(pending_, matches);
+    }
+
+    /** @brief Bumped each time a listener is added or removed from any manager. */
+    static auto getListenersVersion() -> uint64_t { return listenersVersion_; }
+
+private:
+    struct Listener
+    {
+        EventCallback callback;
+        uint32_t eventId{0};
+        ListenerHandle handle{0};
+    };
+
+    /* Apply what changed while emitting. */
+    auto settle() -> void
+    {
+        std::erase_if(listeners_, [](const Listener& l) { return !l.handle; });
+        hasRemovals_ = false;
+        if (pending_.empty()) { return; }
 
-        eventMap_[key](event);
+        std::ranges::move(pending_, std::back_inserter(listeners_));
+        pending_.clear();
     }
 
 private:
-    std::unordered_map<uint32_t, EventCallback> eventMap_;
+    std::vector<Listener> listeners_;
+    std::vector<Listener> pending_;
+    ListenerHandle lastHandle_{0};
+    uint32_t emitDepth_{0};
+    bool hasRemovals_{false};
+    inline static uint64_t listenersVersion_{0};
 };
 } //namespace lav::core
@@ -7,6 +7,7 @@
 // #include "src/Uinodes/UISlider.hpp"
 #include "src/Utils/Logger.hpp"
 #include "src/Utils/Misc.hpp"
+#include "src/Utils/Profiler.hpp"
 #include <optional>
 
 namespace lav::core
@@ -31,6 +32,8 @@ auto BasicCalculator::get() -> BasicCalculator&
 auto BasicCalculator::calculateScaleForGenericElement(node::UIBase* parent,
     const glm::vec2 shrinkScaleBy) const -> void
 {
+    LAV_PROFILE_ZONE("BasicCalculator::calculateScaleForGenericElement");
+
     const auto& elements = parent->getElements();
     if (elements.empty()) { return; }
 
@@ -142,6 +145,8 @@ auto BasicCalculator::calculateScaleForGenericElement(node::UIBase* parent,
 auto BasicCalculator::calculatePositionForGenericElement(node::UIBase* parent,
     const glm::vec2 shrinkScaleBy) const -> void
 {
+    LAV_PROFILE_ZONE("BasicCalculator::calculatePositionForGenericElement");
+
     const auto& elements = parent->getElements();
     if (elements.empty()) { return; }
 
@@ -215,6 +220,8 @@ auto BasicCalculator::calculatePositionForGenericElement(node::UIBase* parent,
 auto BasicCalculator::calculateAlignmentForElements(node::UIBase* node,
     const glm::vec2 overflow) const -> void
 {
+    LAV_PROFILE_ZONE("BasicCalculator::calculateAlignmentForElements");
+
     if (overflow.x >= 0 && overflow.y >= 0) { return; }
 
     /* Note: negative overflow means there's `-overflow` pixels left until an overflow occurs.
@@ -281,6 +288,8 @@ auto BasicCalculator::calculateAlignmentForElements(node::UIBase* node,
 auto BasicCalculator::calculateElementOverflow(node::UIBase* parent,
     const glm::vec2 shrinkScaleBy) const -> glm::vec2
 {
+    LAV_PROFILE_ZONE("BasicCalculator::calculateElementOverflow");
+
     glm::vec2 boxScale{0, 0};
     const auto& elements = parent->getElements();
     const auto& pLayout = parent->getBaseLayoutData();
@@ -437,6 +446,8 @@ auto BasicCalculator::calculateSpacingOnAxis(node::UIBase* parent,
 
 auto BasicCalculator::calculateSlidersScaleAndPos(node::UIPane* parent) const -> glm::vec2
 {
+    LAV_PROFILE_ZONE("BasicCalculator::calculateSlidersScaleAndPos");
+
     glm::vec2 sliderImpact{0, 0};
     const auto& pLayout = parent->getBaseLayoutData();
     const auto& pComputedPos = pLayout.getComputedPos();
@@ -471,6 +482,8 @@ auto BasicCalculator::calculateSlidersScaleAndPos(node::UIPane* parent) const ->
 auto BasicCalculator::calculateElementsOffsetDueToScroll(node::UIPane* parent,
     const glm::ivec2 offset) const -> void
 {
+    LAV_PROFILE_ZONE("BasicCalculator::calculateElementsOffsetDueToScroll");
+
     const auto& elements = parent->getElements();
     for (const auto& element : elements)
     {
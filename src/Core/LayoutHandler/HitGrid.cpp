@@ -0,0 +1,89 @@
+#include "HitGrid.hpp"
+
+#include <algorithm>
+
+namespace lav::core
+{
+auto HitGrid::reset(const glm::ivec2& area) -> void
+{
+    cellCount_ = glm::max(glm::ivec2{1, 1}, (area + CELL_SIZE - 1) / CELL_SIZE);
+    entries_.clear();
+    cellStart_.clear();
+    cellEntries_.clear();
+}
+
+auto HitGrid::insert(const uint32_t id, const glm::ivec4& rect, const uint32_t zIndex) -> void
+{
+    if (rect.z <= 0 || rect.w <= 0) { return; }
+    entries_.emplace_back(Entry{.rect = rect, .id = id, .zIndex = zIndex});
+}
+
+auto HitGrid::build() -> void
+{
+    ++stats_.rebuilds;
+
+    /* Two passes: count references per cell, then fill them in. Keeps each cell contiguous in memory. */
+    const uint32_t cellsTotal = cellCount_.x * cellCount_.y;
+    cellStart_.assign(cellsTotal + 1, 0);
+    for (const auto& entry : entries_)
+    {
+        const glm::ivec2 from = cellOf({entry.rect.x, entry.rect.y});
+        const glm::ivec2 to = cellOf({entry.rect.x + entry.rect.z, entry.rect.y + entry.rect.w});
+        for (int32_t y = from.y; y <= to.y; ++y)
+        {
+            for (int32_t x = from.x; x <= to.x; ++x) { ++cellStart_[y * cellCount_.x + x + 1]; }
+        }
+    }
+
+    for (uint32_t i = 1; i <= cellsTotal; ++i) { cellStart_[i] += cellStart_[i - 1]; }
+
+    cellEntries_.resize(cellStart_[cellsTotal]);
+    std::vector<uint32_t> cursor(cellStart_.begin(), cellStart_.end() - 1);
+    for (uint32_t i = 0; i < entries_.size(); ++i)
+    {
+        const auto& rect = entries_[i].rect;
+        const glm::ivec2 from = cellOf({rect.x, rect.y});
+        const glm::ivec2 to = cellOf({rect.x + rect.z, rect.y + rect.w});
+        for (int32_t y = from.y; y <= to.y; ++y)
+        {
+            for (int32_t x = from.x; x <= to.x; ++x) { cellEntries_[cursor[y * cellCount_.x + x]++] = i; }
+        }
+    }
+}
+
+auto HitGrid::query(const glm::ivec2& point) const -> uint32_t
+{
+    ++stats_.queries;
+    if (cellStart_.empty()) { return 0; }
+
+    const glm::ivec2 cell = cellOf(point);
+    const uint32_t cellIndex = cell.y * cellCount_.x + cell.x;
+
+    uint32_t hitId{0};
+    uint32_t maxZIndex{0};
+    for (uint32_t i = cellStart_[cellIndex]; i < cellStart_[cellIndex + 1]; ++i)
+    {
+        const Entry& entry = entries_[cellEntries_[i]];
+        ++stats_.candidatesTested;
+
+        const auto& r = entry.rect;
+        if (entry.zIndex > maxZIndex
+            && point.x >= r.x && point.x <= r.x + r.z
+            && point.y >= r.y && point.y <= r.y + r.w)
+        {
+            hitId = entry.id;
+            maxZIndex = entry.zIndex;
+        }
+    }
+
+    return hitId;
+}
+
+auto HitGrid::getStats() const -> const Stats& { return stats_; }
+
+auto HitGrid::cellOf(const glm::ivec2& point) const -> glm::ivec2
+{
+    /* Anything outside the covered area lands in the border cells. */
+    return glm::clamp(point / CELL_SIZE, glm::ivec2{0, 0}, cellCount_ - 1);
+}
+} // namespace lav::core
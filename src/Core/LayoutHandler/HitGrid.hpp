@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "vendor/glm/glm.hpp"
+
+namespace lav::core
+{
+/**
+    @brief Uniform grid over view boxes used to answer "what's the top most element under this point"
+        without walking the whole tree.
+
+    @note Filled with reset/insert/build after the tree view boxes changed. Each box is referenced by every
+        cell it overlaps so a query only needs to look at the boxes of a single cell.
+    @note Insertion order matters: on equal zIndex the first inserted box wins, same as the old tree scan.
+*/
+class HitGrid
+{
+public:
+    struct Stats
+    {
+        uint64_t rebuilds{0};
+        uint64_t queries{0};
+        uint64_t candidatesTested{0};
+    };
+
+public:
+    HitGrid() = default;
+
+    /**
+        @brief Start a new build covering the given area. Previous content is discarded.
+
+        @param area Size of the area covered by the grid, starting at {0, 0}
+    */
+    auto reset(const glm::ivec2& area) -> void;
+
+    /**
+        @brief Add a box to the grid. Boxes with no area can never be hit and are ignored.
+
+        @param id Value returned when the box is hit
+        @param rect Box to add (x, y, width, height). Edges are inclusive
+        @param zIndex Boxes with higher zIndex win over lower ones. Zero never wins
+    */
+    auto insert(const uint32_t id, const glm::ivec4& rect, const uint32_t zIndex) -> void;
+
+    /** @brief Finish the build. Needs to be called before querying. */
+    auto build() -> void;
+
+    /**
+        @brief Find the highest zIndex box containing the point.
+
+        @param point Point to test
+
+        @return Id of the box or 0 if nothing was hit.
+    */
+    auto query(const glm::ivec2& point) const -> uint32_t;
+
+    auto getStats() const -> const Stats&;
+
+private:
+    struct Entry
+    {
+        glm::ivec4 rect{0};
+        uint32_t id{0};
+        uint32_t zIndex{0};
+    };
+
+    auto cellOf(const glm::ivec2& point) const -> glm::ivec2;
+
+private:
+    static constexpr int32_t CELL_SIZE{64};
+
+    glm::ivec2 cellCount_{0, 0};
+    std::vector<Entry> entries_;
+    std::vector<uint32_t> cellStart_;
+    std::vector<uint32_t> cellEntries_;
+    mutable Stats stats_;
+};
+} // namespace lav::core
@@ -41,6 +41,8 @@ auto LayoutBase::computeViewBox(const LayoutBase& parentAttribs) -> void
     const glm::vec2 pBorderPos = { parentAttribs.getBorder().left, parentAttribs.getBorder().top };
     const glm::ivec2 pBorderScale = { parentAttribs.getLRBorder(), parentAttribs.getTBBorder()};
 
+    const glm::ivec2 oldViewPos = viewPos_;
+    const glm::ivec2 oldViewScale = viewScale_;
     viewPos_ = {
         std::max((float)parentAttribs.viewPos_.x + pBorderPos.x, computedPos_.x),
         std::max((float)parentAttribs.viewPos_.y + pBorderPos.y, computedPos_.y)
@@ -61,6 +63,71 @@ auto LayoutBase::computeViewBox(const LayoutBase& parentAttribs) -> void
         // std::round(std::max(0.0f, std::min(pViewEnd.x, thisEnd.x) - viewPos_.x)),
         // std::round(std::max(0.0f, std::min(pViewEnd.y, thisEnd.y) - viewPos_.y))
     };
+
+    if (oldViewPos != viewPos_ || oldViewScale != viewScale_) { isViewDirty_ = true; }
+}
+
+auto LayoutBase::markDirty(const bool affectsParent) -> void
+{
+    isDirty_ = true;
+
+    /* Parent is the one computing our scale and position so it needs to run again. If the parent wraps
+        around it's children (FIT) then it's scale changes as well and so it's own parent needs to run
+        again, and so on until the first non FIT ancestor. */
+    LayoutBase* top = this;
+    if (affectsParent && parentLayout_)
+    {
+        top = parentLayout_;
+        top->isDirty_ = true;
+        while (top->isFit() && top->parentLayout_)
+        {
+            top = top->parentLayout_;
+            top->isDirty_ = true;
+        }
+    }
+
+    /* Make sure the layout pass will actually get down to the dirty nodes. */
+    markAncestorsSubtreeDirty();
+    top->markAncestorsSubtreeDirty();
+}
+
+auto LayoutBase::markRenderDirty() -> void
+{
+    isRenderDirty_ = true;
+    markAncestorsSubtreeDirty();
+}
+
+auto LayoutBase::consumeDamage() -> glm::ivec4
+{
+    /* Both where the node was and where it is now need to be redrawn. */
+    const glm::ivec4 currentView{viewPos_, viewScale_};
+    const glm::ivec4 damage = utils::rectUnion(damagedView_, currentView);
+    damagedView_ = currentView;
+    isRenderDirty_ = false;
+    return damage;
+}
+
+auto LayoutBase::markAncestorsSubtreeDirty() -> void
+{
+    /* Stopping at the first already marked ancestor is fine as the ones above it are either marked
+        as well or the ancestor is already queued for processing this pass. */
+    for (LayoutBase* node = parentLayout_; node && !node->isSubtreeDirty_; node = node->parentLayout_)
+    {
+        node->isSubtreeDirty_ = true;
+    }
+}
+
+auto LayoutBase::clearDirty() -> void { isDirty_ = false; }
+auto LayoutBase::clearViewDirty() -> void { isViewDirty_ = false; }
+auto LayoutBase::clearSubtreeDirty() -> void { isSubtreeDirty_ = false; }
+auto LayoutBase::isDirty() const -> bool { return isDirty_; }
+auto LayoutBase::isViewDirty() const -> bool { return isViewDirty_; }
+auto LayoutBase::isSubtreeDirty() const -> bool { return isSubtreeDirty_; }
+auto LayoutBase::isRenderDirty() const -> bool { return isRenderDirty_; }
+
+auto LayoutBase::isFit() const -> bool
+{
+    return userScale_.x.type == ScaleType::FIT || userScale_.y.type == ScaleType::FIT;
 }
 
 auto LayoutBase::getTransform() -> const glm::mat4&
@@ -148,32 +215,63 @@ auto LayoutBase::getZIndex() const -> uint32_t { return index_; }
 auto LayoutBase::getAngle() const -> float { return angle_; }
 auto LayoutBase::isCustomIndex() const -> bool { return isCustomIndex_; }
 
-auto LayoutBase::setType(Type val) -> LayoutBase& { layoutType_ = val; return *this; }
-auto LayoutBase::setMargin(const TBLR& val) -> LayoutBase& { margin_ = val; return *this; }
-auto LayoutBase::setPadding(const TBLR& val) -> LayoutBase& { padding_ = val; return *this; }
-auto LayoutBase::setBorder(const TBLR& val) -> LayoutBase& { border_ = val; return *this; }
-auto LayoutBase::setBorderRadius(const TBLR& val) -> LayoutBase& { borderRadius_ = val; return *this;}
+/* Anything affecting how the element or it's children are placed invalidates the layout. Render only
+    properties (radius) only damage the node. */
+auto LayoutBase::setType(Type val) -> LayoutBase& { layoutType_ = val; markDirty(); return *this; }
+auto LayoutBase::setMargin(const TBLR& val) -> LayoutBase& { margin_ = val; markDirty(); return *this; }
+auto LayoutBase::setPadding(const TBLR& val) -> LayoutBase& { padding_ = val; markDirty(); return *this; }
+auto LayoutBase::setBorder(const TBLR& val) -> LayoutBase& { border_ = val; markDirty(); return *this; }
+auto LayoutBase::setBorderRadius(const TBLR& val) -> LayoutBase& { borderRadius_ = val; markRenderDirty(); return *this;}
 auto LayoutBase::setShadow(const TBLR& val) -> LayoutBase& { shadow_ = val; return *this; }
-auto LayoutBase::setSelfAlign(const Align val) -> LayoutBase& { selfAlign_ = val; return *this; }
-auto LayoutBase::setAlign(const Align val) -> LayoutBase& { align_ = val; return *this; }
-auto LayoutBase::setSpacing(const Spacing val) -> LayoutBase& { spacing_ = val; return *this; }
-auto LayoutBase::setGrid(const GridPolicyXY value) -> LayoutBase& { gridPolicy_ = value; return *this; }
-auto LayoutBase::setGridPos(const GridRC value) -> LayoutBase& { gridPos_ = value; return *this; }
-auto LayoutBase::setGridSpan(const GridRC value) -> LayoutBase& { gridSpan_ = value; return *this; }
-auto LayoutBase::setMinScale(const glm::ivec2 val) -> LayoutBase& { minScale_ = val; return *this; }
-auto LayoutBase::setMaxScale(const glm::ivec2 val) -> LayoutBase& { maxScale_ = val; return *this; }
-auto LayoutBase::setWrap(const bool val) -> LayoutBase& { wrap = val; return *this; }
-auto LayoutBase::setPos(const PositionXY& val) -> LayoutBase& { userPos_ = val; return *this; }
-auto LayoutBase::setScale(const ScaleXY& val) -> LayoutBase& { userScale_ = val; return *this; }
+auto LayoutBase::setSelfAlign(const Align val) -> LayoutBase& { selfAlign_ = val; markDirty(); return *this; }
+auto LayoutBase::setAlign(const Align val) -> LayoutBase& { align_ = val; markDirty(); return *this; }
+auto LayoutBase::setSpacing(const Spacing val) -> LayoutBase& { spacing_ = val; markDirty(); return *this; }
+auto LayoutBase::setGrid(const GridPolicyXY value) -> LayoutBase& { gridPolicy_ = value; markDirty(); return *this; }
+auto LayoutBase::setGridPos(const GridRC value) -> LayoutBase& { gridPos_ = value; markDirty(); return *this; }
+auto LayoutBase::setGridSpan(const GridRC value) -> LayoutBase& { gridSpan_ = value; markDirty(); return *this; }
+auto LayoutBase::setMinScale(const glm::ivec2 val) -> LayoutBase& { minScale_ = val; markDirty(); return *this; }
+auto LayoutBase::setMaxScale(const glm::ivec2 val) -> LayoutBase& { maxScale_ = val; markDirty(); return *this; }
+auto LayoutBase::setWrap(const bool val) -> LayoutBase& { wrap = val; markDirty(); return *this; }
+auto LayoutBase::setPos(const PositionXY& val) -> LayoutBase& { userPos_ = val; markDirty(); return *this; }
+auto LayoutBase::setScale(const ScaleXY& val) -> LayoutBase& { userScale_ = val; markDirty(); return *this; }
 // auto LayoutBase::setComputedPos(const glm::vec2& val) -> LayoutBase& { computedPos_ = utils::round(val); return *this; }
 // auto LayoutBase::setComputedScale(const glm::vec2& val) -> LayoutBase& {computedScale_ = utils::round(val) ;return *this;}
-auto LayoutBase::setComputedPos(const glm::vec2& val) -> LayoutBase& { computedPos_ = val; return *this; }
-auto LayoutBase::setComputedScale(const glm::vec2& val) -> LayoutBase& {computedScale_ = val ;return *this;}
-auto LayoutBase::setViewPos(const glm::vec2& val) -> LayoutBase& { viewPos_ = val; return *this; }
-auto LayoutBase::setViewScale(const glm::vec2& val) -> LayoutBase& { viewScale_ = val; return *this; }
-auto LayoutBase::setZIndex(uint32_t val) -> LayoutBase& { index_ = val;  return *this; }
-auto LayoutBase::setEnableCustomIndex(const bool val) -> LayoutBase& { isCustomIndex_ = val;  return *this; }
+
+/* Computed values are set by the parent's layout pass which will check the children right after, so
+    there is no need to propagate anything upwards. */
+auto LayoutBase::setComputedPos(const glm::vec2& val) -> LayoutBase&
+{
+    if (computedPos_ != val) { computedPos_ = val; isDirty_ = true; }
+    return *this;
+}
+
+auto LayoutBase::setComputedScale(const glm::vec2& val) -> LayoutBase&
+{
+    if (computedScale_ != val) { computedScale_ = val; isDirty_ = true; }
+    return *this;
+}
+
+auto LayoutBase::setViewPos(const glm::vec2& val) -> LayoutBase&
+{
+    if (viewPos_ != glm::ivec2{val}) { viewPos_ = val; isViewDirty_ = true; }
+    return *this;
+}
+
+auto LayoutBase::setViewScale(const glm::vec2& val) -> LayoutBase&
+{
+    if (viewScale_ != glm::ivec2{val}) { viewScale_ = val; isViewDirty_ = true; }
+    return *this;
+}
+
+auto LayoutBase::setZIndex(uint32_t val) -> LayoutBase&
+{
+    if (index_ != val) { index_ = val; isDirty_ = true; }
+    return *this;
+}
+
+auto LayoutBase::setEnableCustomIndex(const bool val) -> LayoutBase& { isCustomIndex_ = val; markDirty(false); return *this; }
 auto LayoutBase::setAngle(float val) -> LayoutBase& { angle_ = val; return *this; }
+auto LayoutBase::setParentLayout(LayoutBase* parent) -> LayoutBase& { parentLayout_ = parent; return *this; }
 
 auto LayoutBase::isVertical() const -> bool { return layoutType_ == Type::VERTICAL; }
 auto LayoutBase::isHorizontal() const -> bool { return layoutType_ == Type::HORIZONTAL; }
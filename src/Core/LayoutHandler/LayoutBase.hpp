@@ -138,6 +138,17 @@ public:
     auto computeOffsetToCenter(const glm::ivec2& p) const -> glm::ivec2;
     auto distanceToCenter(const glm::ivec2& p) const -> float;
     auto computeViewBox(const LayoutBase& parentAttribs) -> void;
+    auto markDirty(const bool affectsParent = true) -> void;
+    auto markRenderDirty() -> void;
+    auto consumeDamage() -> glm::ivec4;
+    auto clearDirty() -> void;
+    auto clearViewDirty() -> void;
+    auto clearSubtreeDirty() -> void;
+    auto isDirty() const -> bool;
+    auto isViewDirty() const -> bool;
+    auto isSubtreeDirty() const -> bool;
+    auto isRenderDirty() const -> bool;
+    auto isFit() const -> bool;
     auto getLRMargin() const -> int32_t;
     auto getTBMargin() const -> int32_t;
     auto getLRBorder() const -> int32_t;
@@ -198,6 +209,7 @@ public:
     auto setZIndex(uint32_t value) -> LayoutBase&;
     auto setEnableCustomIndex(const bool val) -> LayoutBase&;
     auto setAngle(float value) -> LayoutBase&;
+    auto setParentLayout(LayoutBase* parent) -> LayoutBase&;
 
     auto isVertical() const -> bool;
     auto isHorizontal() const -> bool;
@@ -249,8 +261,29 @@ protected:
     float angle_{30.0f};
     bool isCustomIndex_{false};
 
+private:
+    auto markAncestorsSubtreeDirty() -> void;
+
 private:
     glm::mat4 transform_{glm::mat4{1}};
+
+    /** @brief Layout data of the parent node. Used only to propagate invalidations upwards. */
+    LayoutBase* parentLayout_{nullptr};
+
+    /** @brief Invalidation flags. Everything starts dirty so the first pass lays out the whole tree.
+        `isDirty_` - the node's layout() needs to run again (it places the node's children).
+        `isViewDirty_` - the node's view box changed so the view boxes of it's children need recomputing.
+        `isSubtreeDirty_` - some descendant has one of the above set so the subtree can't be skipped.
+    */
+    bool isDirty_{true};
+    bool isViewDirty_{true};
+    bool isSubtreeDirty_{true};
+
+    /** @brief Looks of the node changed without affecting the layout (color, text, etc). */
+    bool isRenderDirty_{true};
+
+    /** @brief View box (x, y, w, h) as it was when damage was last consumed. */
+    glm::ivec4 damagedView_{0};
 };
 
 LayoutBase::Scale operator"" _fill(unsigned long long);
@@ -0,0 +1,203 @@
+#include "BatchRenderer.hpp"
+
+#include "src/Core/Binders/GPUBinder.hpp"
+#include "src/Core/ResourceHandler/FontLoader.hpp"
+#include "src/Core/ResourceHandler/MeshLoader.hpp"
+#include "src/Core/ResourceHandler/ShaderLoader.hpp"
+#include "src/Utils/Misc.hpp"
+#include "src/Utils/Profiler.hpp"
+
+namespace lav::core
+{
+/* Instance data is uploaded as is, any padding would break the attribute strides. */
+static_assert(sizeof(BatchRenderer::QuadInstance) == 8 * sizeof(glm::vec4));
+static_assert(sizeof(BatchRenderer::GlyphInstance) == 18 * sizeof(float));
+
+auto BatchRenderer::get() -> BatchRenderer&
+{
+    static BatchRenderer instance;
+    return instance;
+}
+
+BatchRenderer::BatchRenderer()
+    : log_("BatchRenderer")
+    , instanceBufferId_(GPUBinder::get().createBuffer())
+    , instancedVao_(MeshLoader::get().loadInstancedQuad(instanceBufferId_, {4, 4, 4, 4, 4, 4, 4, 4}))
+    , textBufferId_(GPUBinder::get().createBuffer())
+    , textVao_(MeshLoader::get().loadInstancedQuad(textBufferId_, {4, 4, 4, 4, 2}))
+    , shader_(ShaderLoader::get().load(
+        "assets/shaders/batchedElemVert.glsl", "assets/shaders/batchedElemFrag.glsl"))
+    , textShader_(ShaderLoader::get().load(
+        "assets/shaders/batchedTextVert.glsl", "assets/shaders/batchedTextFrag.glsl"))
+{}
+
+auto BatchRenderer::begin(const glm::mat4& projection, const glm::ivec2& windowSize,
+    const glm::ivec4& drawArea) -> void
+{
+    projection_ = projection;
+    windowSize_ = windowSize;
+    drawArea_ = drawArea;
+    instances_.clear();
+    groups_.clear();
+    texts_.clear();
+    stats_ = {};
+}
+
+auto BatchRenderer::pushQuad(const QuadInstance& instance, const uint32_t textureId) -> void
+{
+    /* Untextured quads can join any group. Textured ones break the group only if the group already
+        needs a different texture bound. */
+    if (groups_.empty() || (textureId && groups_.back().textureId && groups_.back().textureId != textureId))
+    {
+        groups_.emplace_back(Group{
+            .textureId = textureId,
+            .start = static_cast<uint32_t>(instances_.size()),
+            .count = 0});
+    }
+
+    Group& group = groups_.back();
+    if (textureId) { group.textureId = textureId; }
+    ++group.count;
+
+    instances_.emplace_back(instance);
+}
+
+auto BatchRenderer::pushText(const TextAttribs& textAttribs, const glm::vec4& color,
+    const glm::ivec4& clipRect) -> void
+{
+    if (textAttribs.getGlyphs().empty()) { return; }
+    texts_.emplace_back(TextDraw{
+        .attribs = &textAttribs,
+        .version = textAttribs.getVersion(),
+        .color = color,
+        .clipRect = clipRect});
+}
+
+auto BatchRenderer::end() -> void
+{
+    LAV_PROFILE_ZONE("BatchRenderer::end");
+
+    flushQuads();
+    flushText();
+
+    /* Leave the scissor area as it was before the batch started. */
+    GPUBinder::get().setScissorsArea({0, 0, windowSize_.x, windowSize_.y});
+}
+
+auto BatchRenderer::getStats() const -> const Stats& { return stats_; }
+
+auto BatchRenderer::setScissorsFromArea(const glm::ivec4& area) const -> void
+{
+    /* Scissor works from the bottom left corner while the area is from the top left. */
+    GPUBinder::get().setScissorsArea({area.x, windowSize_.y - area.y - area.w, area.z, area.w});
+}
+
+auto BatchRenderer::makeInstance(const LayoutBase& layout, const glm::vec4& color,
+    const glm::vec4& borderColor) -> QuadInstance
+{
+    const auto& pos = layout.getComputedPos();
+    const auto& scale = layout.getComputedScale();
+    const auto& viewPos = layout.getViewPos();
+    const auto& viewScale = layout.getViewScale();
+    return QuadInstance{
+        .rect = {pos.x, pos.y, scale.x, scale.y},
+        .color = color,
+        .borderSize = layout.getBorder(),
+        .borderRadii = layout.getBorderRadius(),
+        .borderColor = borderColor,
+        .clipRect = {viewPos.x, viewPos.y, viewScale.x, viewScale.y},
+        .params = {layout.getZIndex(), -1.0f, 0.0f, 0.0f}};
+}
+
+auto BatchRenderer::flushQuads() -> void
+{
+    if (instances_.empty()) { return; }
+
+    auto& gpuBinder = GPUBinder::get();
+
+    /* Clipping is done per instance in the shader. */
+    setScissorsFromArea(drawArea_);
+    gpuBinder.bufferInstanceData(instanceBufferId_, instances_.data(),
+        instances_.size() * sizeof(QuadInstance), instanceBufferCapacity_);
+
+    gpuBinder.useVao(instancedVao_);
+    shader_.bind();
+    shader_.uploadMat4(Uniform::MATRIX_PROJECTION, projection_);
+    for (const auto& group : groups_)
+    {
+        if (group.textureId) { shader_.uploadTexture2D(Uniform::TEXTURE, 0, group.textureId); }
+        gpuBinder.renderBoundQuadInstanced(group.count, group.start);
+        ++stats_.drawCalls;
+    }
+
+    stats_.instances = instances_.size();
+}
+
+auto BatchRenderer::flushText() -> void
+{
+    if (texts_.empty()) { return; }
+
+    /* Glyphs first used during this frame's layout are only on the CPU so far. */
+    FontLoader::get().uploadPendingGlyphs();
+
+    auto& gpuBinder = GPUBinder::get();
+
+    /* Same text objects, unchanged, with the same color and clip as last time. Buffer is still good. */
+    if (texts_ != uploadedTexts_)
+    {
+        buildTextInstances();
+        gpuBinder.bufferInstanceData(textBufferId_, glyphInstances_.data(),
+            glyphInstances_.size() * sizeof(GlyphInstance), textBufferCapacity_);
+        uploadedTexts_ = texts_;
+        ++stats_.textUploads;
+    }
+
+    setScissorsFromArea(drawArea_);
+    gpuBinder.useVao(textVao_);
+    textShader_.bind();
+    textShader_.uploadMat4(Uniform::MATRIX_PROJECTION, projection_);
+    for (const auto& group : textGroups_)
+    {
+        /* Texture id is read only now as the atlas can grow (and get a new id) right before drawing. */
+        textShader_.uploadTexture2DArray(Uniform::TEXTURE_ARRAY, 0, group.atlas->textureId);
+        textShader_.uploadInt(Uniform::SDF, group.atlas->renderMode == Font::RenderMode::SDF);
+        gpuBinder.renderBoundQuadInstanced(group.count, group.start);
+        ++stats_.drawCalls;
+    }
+
+    stats_.glyphs = glyphInstances_.size();
+}
+
+auto BatchRenderer::buildTextInstances() -> void
+{
+    glyphInstances_.clear();
+    textGroups_.clear();
+    for (const auto& text : texts_)
+    {
+        /* Consecutive text using the same atlas can be drawn together, even if the sizes differ (SDF). */
+        const Font* atlas = &text.attribs->getFont()->getAtlas();
+        if (textGroups_.empty() || textGroups_.back().atlas != atlas)
+        {
+            textGroups_.emplace_back(TextGroup{
+                .atlas = atlas,
+                .start = static_cast<uint32_t>(glyphInstances_.size()),
+                .count = 0});
+        }
+
+        /* Shaped glyphs are relative to the text origin. */
+        const glm::vec3& origin = text.attribs->getPosition();
+        const glm::vec4 offset{origin.x, origin.y, 0.0f, 0.0f};
+        const glm::vec4 clipRect{text.clipRect};
+        for (const auto& glyph : text.attribs->getGlyphs())
+        {
+            glyphInstances_.emplace_back(GlyphInstance{
+                .rect = glyph.rect + offset,
+                .uvRect = glyph.uvRect,
+                .clipRect = clipRect,
+                .color = text.color,
+                .params = {origin.z + TEXT_Z_OFFSET, glyph.page}});
+        }
+        textGroups_.back().count += text.attribs->getGlyphs().size();
+    }
+}
+} // namespace lav::core
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "src/Core/LayoutHandler/LayoutBase.hpp"
+#include "src/Core/ResourceHandler/Shader.hpp"
+#include "src/Core/TextHandler/TextAttribs.hpp"
+#include "src/Utils/Logger.hpp"
+#include "vendor/glm/glm.hpp"
+
+namespace lav::core
+{
+/**
+    @brief Collects all the quads of a window frame into a single instance buffer and draws them with
+        as few instanced draw calls as possible.
+
+    @note Quads are drawn in the order they are pushed, so the painter's order of the tree traversal is
+        kept. A new draw call is issued only when a textured quad needs a different texture than the one
+        already bound for the current group.
+    @note Clipping to the element's view box is done in the fragment shader instead of glScissor so that
+        elements with different view boxes can live in the same draw call.
+    @note Text goes through its own instance buffer, drawn after all the quads have been flushed. It's only
+        re-uploaded when the set of text pushed differs from the previous batch.
+    @note Everything is additionally restricted to the `drawArea` given at the start of the batch. This is
+        what allows redrawing only the damaged part of a window.
+*/
+class BatchRenderer
+{
+public:
+    /** @brief Per instance data. Layout needs to match the one from batchedElemVert.glsl. */
+    struct QuadInstance
+    {
+        glm::vec4 rect{0.0f};         /* x, y, w, h */
+        glm::vec4 color{0.0f};
+        glm::vec4 borderSize{0.0f};
+        glm::vec4 borderRadii{0.0f};
+        glm::vec4 borderColor{0.0f};
+        glm::vec4 clipRect{0.0f};     /* x, y, w, h */
+        glm::vec4 params{0.0f, -1.0f, 0.0f, 0.0f}; /* x - zIndex, y - texture layer (negative = none) */
+        glm::vec4 uvRect{0.0f, 0.0f, 1.0f, 1.0f};  /* Region of the texture to sample, for atlased images */
+    };
+
+    /** @brief Per glyph data. Layout needs to match the one from batchedTextVert.glsl. */
+    struct GlyphInstance
+    {
+        glm::vec4 rect{0.0f};     /* x, y, w, h */
+        glm::vec4 uvRect{0.0f};   /* Normalized x, y, w, h inside the atlas page */
+        glm::vec4 clipRect{0.0f}; /* x, y, w, h */
+        glm::vec4 color{0.0f};
+        glm::vec2 params{0.0f};   /* x - zIndex, y - atlas page */
+    };
+
+    struct Stats
+    {
+        uint32_t drawCalls{0};
+        uint32_t instances{0};
+        uint32_t glyphs{0};
+        uint32_t textUploads{0};
+    };
+
+public:
+    static auto get() -> BatchRenderer&;
+
+    auto begin(const glm::mat4& projection, const glm::ivec2& windowSize, const glm::ivec4& drawArea) -> void;
+    auto pushQuad(const QuadInstance& instance, const uint32_t textureId = 0) -> void;
+    auto pushText(const TextAttribs& textAttribs, const glm::vec4& color, const glm::ivec4& clipRect) -> void;
+    auto end() -> void;
+
+    auto getStats() const -> const Stats&;
+
+    static auto makeInstance(const LayoutBase& layout, const glm::vec4& color,
+        const glm::vec4& borderColor) -> QuadInstance;
+
+private:
+    struct Group
+    {
+        uint32_t textureId{0};
+        uint32_t start{0};
+        uint32_t count{0};
+    };
+
+    struct TextDraw
+    {
+        const TextAttribs* attribs{nullptr};
+        uint64_t version{0};
+        glm::vec4 color{0.0f};
+        glm::ivec4 clipRect{0};
+
+        auto operator==(const TextDraw&) const -> bool = default;
+    };
+
+    struct TextGroup
+    {
+        const Font* atlas{nullptr};
+        uint32_t start{0};
+        uint32_t count{0};
+    };
+
+    /* Lifts text just above its element. Same for every glyph so long texts stay within their own layer. */
+    static constexpr float TEXT_Z_OFFSET{0.1f};
+
+private:
+    BatchRenderer();
+    ~BatchRenderer() = default;
+    BatchRenderer(const BatchRenderer&) = delete;
+    BatchRenderer(BatchRenderer&&) = delete;
+    BatchRenderer& operator=(const BatchRenderer&) = delete;
+    BatchRenderer& operator=(BatchRenderer&&) = delete;
+
+    auto flushQuads() -> void;
+    auto flushText() -> void;
+    auto buildTextInstances() -> void;
+    auto setScissorsFromArea(const glm::ivec4& area) const -> void;
+
+private:
+    utils::Logger log_;
+    uint32_t instanceBufferId_{0};
+    uint64_t instanceBufferCapacity_{0};
+    uint32_t instancedVao_{0};
+    uint32_t textBufferId_{0};
+    uint64_t textBufferCapacity_{0};
+    uint32_t textVao_{0};
+    Shader shader_;
+    Shader textShader_;
+    glm::mat4 projection_{1.0f};
+    glm::ivec2 windowSize_{0, 0};
+    glm::ivec4 drawArea_{0};
+    std::vector<QuadInstance> instances_;
+    std::vector<Group> groups_;
+    std::vector<TextDraw> texts_;
+    std::vector<TextDraw> uploadedTexts_;
+    std::vector<GlyphInstance> glyphInstances_;
+    std::vector<TextGroup> textGroups_;
+    Stats stats_;
+};
+} // namespace lav::core
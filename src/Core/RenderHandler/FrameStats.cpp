@@ -0,0 +1,74 @@
+#include "FrameStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "src/Utils/Misc.hpp"
+
+namespace lav::core
+{
+auto FrameStats::push(const Metric metric, const float value) -> void
+{
+    Series& series = series_[static_cast<uint8_t>(metric)];
+    series.values[series.next] = value;
+    series.next = (series.next + 1) % WINDOW_SIZE;
+    series.count = std::min(series.count + 1, WINDOW_SIZE);
+}
+
+auto FrameStats::getPercentiles(const Metric metric) const -> Percentiles
+{
+    const Series& series = series_[static_cast<uint8_t>(metric)];
+    if (!series.count) { return {}; }
+
+    /* Only ever asked for a few times a second, sorting a copy is cheap enough. */
+    std::vector<float> sorted(series.values.begin(), series.values.begin() + series.count);
+    std::ranges::sort(sorted);
+
+    const auto rank = [&sorted](const float p)
+    {
+        const uint32_t index = std::ceil(p * sorted.size());
+        return sorted[std::clamp<uint32_t>(index, 1, sorted.size()) - 1];
+    };
+
+    return Percentiles{
+        .p50 = rank(0.50f),
+        .p95 = rank(0.95f),
+        .p99 = rank(0.99f),
+        .max = sorted.back(),
+        .samples = series.count};
+}
+
+auto FrameStats::writeSnapshot(std::ostream& out, const std::string_view label, const double time) const -> void
+{
+    /* Label is usually the window title, so anything can be in it. */
+    out << "{\"label\":";
+    utils::writeJsonString(out, label);
+    out << ",\"time\":" << time;
+
+    for (uint8_t i = 0; i < static_cast<uint8_t>(Metric::COUNT); ++i)
+    {
+        const auto metric = static_cast<Metric>(i);
+        const Percentiles p = getPercentiles(metric);
+        out << ",\"" << getMetricName(metric) << "\":{\"p50\":" << p.p50 << ",\"p95\":" << p.p95
+            << ",\"p99\":" << p.p99 << ",\"max\":" << p.max << ",\"samples\":" << p.samples << '}';
+    }
+    out << "}\n";
+}
+
+auto FrameStats::reset() -> void { series_ = {}; }
+
+auto FrameStats::getMetricName(const Metric metric) -> const char*
+{
+    switch (metric)
+    {
+        case Metric::CPU_TIME_US: return "cpuTimeUs";
+        case Metric::GPU_TIME_US: return "gpuTimeUs";
+        case Metric::NODES_LAID_OUT: return "nodesLaidOut";
+        case Metric::NODES_RENDERED: return "nodesRendered";
+        case Metric::DRAW_CALLS: return "drawCalls";
+        case Metric::COUNT: break;
+    }
+    return "unknown";
+}
+} // namespace lav::core
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+namespace lav::core
+{
+/**
+    @brief Rolling per frame metrics of a window. Keeps the last WINDOW_SIZE samples of each metric and
+        answers percentiles over them.
+
+    @note Metrics are sampled independently. GPU times arrive a few frames late and only when the driver
+        has them, so their samples don't line up with the CPU ones frame by frame.
+*/
+class FrameStats
+{
+public:
+    /**
+        @details CPU_TIME_US - Time spent in run() building the frame, swap/vsync wait excluded.
+        @details GPU_TIME_US - Time the GPU spent executing the frame's commands.
+        @details NODES_LAID_OUT - Nodes whose layout() ran.
+        @details NODES_RENDERED - Nodes whose render() ran.
+        @details DRAW_CALLS - Draw calls issued.
+    */
+    enum class Metric : uint8_t { CPU_TIME_US, GPU_TIME_US, NODES_LAID_OUT, NODES_RENDERED, DRAW_CALLS, COUNT };
+
+    struct Percentiles
+    {
+        float p50{0};
+        float p95{0};
+        float p99{0};
+        float max{0};
+        uint32_t samples{0};
+    };
+
+    static constexpr uint32_t WINDOW_SIZE{512};
+
+public:
+    FrameStats() = default;
+
+    auto push(const Metric metric, const float value) -> void;
+
+    /**
+        @brief Compute percentiles over the samples currently in the window. Nearest rank, no interpolation.
+
+        @param metric Metric to compute for
+
+        @return Percentiles, all zero if there are no samples yet.
+    */
+    auto getPercentiles(const Metric metric) const -> Percentiles;
+
+    /**
+        @brief Write all metrics as a single line JSON object.
+
+        @param out Stream to write to
+        @param label Name of whatever the stats belong to, i.e the window title
+        @param time Time of the snapshot in seconds
+    */
+    auto writeSnapshot(std::ostream& out, const std::string_view label, const double time) const -> void;
+
+    auto reset() -> void;
+
+    static auto getMetricName(const Metric metric) -> const char*;
+
+private:
+    struct Series
+    {
+        std::array<float, WINDOW_SIZE> values{};
+        uint32_t next{0};
+        uint32_t count{0};
+    };
+
+private:
+    std::array<Series, static_cast<uint8_t>(Metric::COUNT)> series_;
+};
+} // namespace lav::core
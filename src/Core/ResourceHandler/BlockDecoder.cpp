@@ -0,0 +1,111 @@
+#include "BlockDecoder.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace lav::core
+{
+namespace
+{
+using Rgba = std::array<uint8_t, 4>;
+
+auto unpack565(const uint16_t c) -> Rgba
+{
+    /* Replicate the high bits into the low ones so 0x1f maps to 0xff. */
+    const uint8_t r = (c >> 11) & 0x1f;
+    const uint8_t g = (c >> 5) & 0x3f;
+    const uint8_t b = c & 0x1f;
+    return {uint8_t((r << 3) | (r >> 2)), uint8_t((g << 2) | (g >> 4)), uint8_t((b << 3) | (b >> 2)), 255};
+}
+
+auto mix(const Rgba& a, const Rgba& b, const uint32_t wa, const uint32_t wb) -> Rgba
+{
+    const uint32_t total = wa + wb;
+    return {uint8_t((a[0] * wa + b[0] * wb) / total), uint8_t((a[1] * wa + b[1] * wb) / total),
+        uint8_t((a[2] * wa + b[2] * wb) / total), 255};
+}
+
+/* Decodes the 8 byte color part of a block. BC3 color blocks always use the 4 color mode. */
+auto decodeColorBlock(const uint8_t* block, const bool isBc1, std::array<Rgba, 16>& out) -> void
+{
+    const uint16_t c0 = block[0] | (block[1] << 8);
+    const uint16_t c1 = block[2] | (block[3] << 8);
+    const uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (uint32_t(block[7]) << 24);
+
+    std::array<Rgba, 4> palette{unpack565(c0), unpack565(c1)};
+    if (c0 > c1 || !isBc1)
+    {
+        palette[2] = mix(palette[0], palette[1], 2, 1);
+        palette[3] = mix(palette[0], palette[1], 1, 2);
+    }
+    else
+    {
+        palette[2] = mix(palette[0], palette[1], 1, 1);
+        palette[3] = {0, 0, 0, 0};
+    }
+
+    for (uint32_t i = 0; i < 16; ++i) { out[i] = palette[(indices >> (2 * i)) & 0x3]; }
+}
+
+auto decodeAlphaBlock(const uint8_t* block, std::array<Rgba, 16>& out) -> void
+{
+    const uint32_t a0 = block[0];
+    const uint32_t a1 = block[1];
+    std::array<uint8_t, 8> palette{uint8_t(a0), uint8_t(a1)};
+    if (a0 > a1)
+    {
+        for (uint32_t i = 1; i < 7; ++i) { palette[i + 1] = ((7 - i) * a0 + i * a1) / 7; }
+    }
+    else
+    {
+        for (uint32_t i = 1; i < 5; ++i) { palette[i + 1] = ((5 - i) * a0 + i * a1) / 5; }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    /* 16 indices of 3 bits each packed in the remaining 6 bytes. */
+    uint64_t indices{0};
+    for (uint32_t i = 0; i < 6; ++i) { indices |= uint64_t(block[2 + i]) << (8 * i); }
+    for (uint32_t i = 0; i < 16; ++i) { out[i][3] = palette[(indices >> (3 * i)) & 0x7]; }
+}
+} // namespace
+
+auto decodeBlocksToRgba(const GPUBinder::CompressedFormat format, const glm::ivec2& size,
+    const std::vector<uint8_t>& blocks) -> std::optional<std::vector<uint8_t>>
+{
+    const bool isBc1 = format == GPUBinder::CompressedFormat::BC1;
+    if (!isBc1 && format != GPUBinder::CompressedFormat::BC3) { return std::nullopt; }
+
+    const uint32_t blockBytes = isBc1 ? 8 : 16;
+    const glm::ivec2 blockCount = (size + 3) / 4;
+    if (blocks.size() < std::size_t(blockCount.x) * blockCount.y * blockBytes) { return std::nullopt; }
+
+    std::vector<uint8_t> pixels(std::size_t(size.x) * size.y * 4);
+    std::array<Rgba, 16> texels;
+    for (int32_t by = 0; by < blockCount.y; ++by)
+    {
+        for (int32_t bx = 0; bx < blockCount.x; ++bx)
+        {
+            const uint8_t* block = blocks.data() + (std::size_t(by) * blockCount.x + bx) * blockBytes;
+            if (isBc1) { decodeColorBlock(block, true, texels); }
+            else
+            {
+                decodeColorBlock(block + 8, false, texels);
+                decodeAlphaBlock(block, texels);
+            }
+
+            /* Edge blocks can hang over the image. */
+            for (int32_t y = 0; y < 4 && by * 4 + y < size.y; ++y)
+            {
+                for (int32_t x = 0; x < 4 && bx * 4 + x < size.x; ++x)
+                {
+                    const std::size_t dst = (std::size_t(by * 4 + y) * size.x + bx * 4 + x) * 4;
+                    std::copy_n(texels[y * 4 + x].begin(), 4, pixels.begin() + dst);
+                }
+            }
+        }
+    }
+
+    return pixels;
+}
+} // namespace lav::core
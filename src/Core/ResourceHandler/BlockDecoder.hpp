@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "src/Core/Binders/GPUBinder.hpp"
+#include "vendor/glm/glm.hpp"
+
+namespace lav::core
+{
+/**
+    @brief Decode block compressed data to RGBA8 on the CPU, for drivers that can't sample the format.
+
+    @note Only BC1 and BC3 are handled. Other formats return nullopt.
+
+    @param format Format of the blocks
+    @param size Size of the image in pixels
+    @param blocks Block data, row major
+
+    @return Tightly packed RGBA8 pixels or nullopt if the format is not handled or the data is too short.
+*/
+auto decodeBlocksToRgba(const GPUBinder::CompressedFormat format, const glm::ivec2& size,
+    const std::vector<uint8_t>& blocks) -> std::optional<std::vector<uint8_t>>;
+} // namespace lav::core
@@ -2,32 +2,75 @@
 
 #include <string>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
+#include "src/Core/ResourceHandler/ShelfPacker.hpp"
 #include "vendor/glm/glm.hpp"
 
+/* Fwd declaration so FreeType doesn't leak everywhere fonts are used. */
+struct FT_FaceRec_;
+
 namespace lav::core
 {
-static constexpr int32_t MAX_GLYPHS        {256};
+static constexpr int32_t ATLAS_PAGE_SIZE   {512};
 static constexpr int32_t DEFAULT_FONT_SIZE {16};
 static constexpr int32_t MIN_FONT_SIZE     {10};
 static constexpr int32_t MAX_FONT_SIZE     {88};
+static constexpr int32_t SDF_BASE_SIZE     {48};
 static const std::string DEFAULT_FONT_PATH {"/home/hekapoo/Documents/probe/move_stuff/assets/fonts/Arial.ttf"};
 
+/**
+    @brief Face loaded at a specific pixel size together with the atlas of glyphs rasterized so far.
+
+    @note Glyphs are rasterized on first use (see FontLoader::getGlyph) into CPU side pages. Pages are
+        layers of the `textureId` 2D array texture and get uploaded in one go by
+        FontLoader::uploadPendingGlyphs before text is drawn.
+    @note SDF fonts of any size don't own glyphs, they share the atlas of the face rasterized at
+        SDF_BASE_SIZE and scale its glyph metrics by `scale`.
+*/
 struct Font
 {
+    enum class RenderMode
+    {
+        BITMAP, /* Coverage bitmaps, crisp only at the size they were rasterized at */
+        SDF     /* Signed distance fields, one atlas per face for all sizes */
+    };
+
     struct GlyphData
     {
-        uint32_t glyphCode;
-        int64_t hAdvance;
-        glm::ivec2 size;
-        glm::ivec2 bearing;
+        uint32_t codepoint{0};
+        int64_t hAdvance{0};
+        glm::ivec2 size{0};
+        glm::ivec2 bearing{0};
+        glm::vec4 uvRect{0.0f}; /* Normalized x, y, w, h inside the page */
+        uint32_t page{0};
     };
 
-    GlyphData glyphData[MAX_GLYPHS];
+    struct AtlasPage
+    {
+        std::vector<uint8_t> pixels;
+        glm::ivec4 dirtyRect{0}; /* x, y, w, h not yet uploaded to the GPU */
+    };
+
+    std::unordered_map<uint32_t, GlyphData> glyphs;
+    std::vector<AtlasPage> pages;
+    ShelfPacker packer{{ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE}};
+    FT_FaceRec_* face{nullptr};
     uint32_t textureId{0};
+    uint32_t texturePages{0};
+    bool hasPendingUploads{false};
+    int32_t ascender{0};   /* Baseline to the top of the line box, in pixels */
+    int32_t descender{0};  /* Baseline to the bottom of the line box, in pixels. Negative */
+    int32_t lineHeight{0}; /* Baseline to baseline distance, in pixels */
     int32_t fontSize{DEFAULT_FONT_SIZE};
     std::string fontPath;
+    RenderMode renderMode{RenderMode::BITMAP};
+    float scale{1.0f};            /* Applied to the glyph metrics of the atlas */
+    std::shared_ptr<Font> atlas;  /* Font owning the glyphs. Null if that's this one */
+
+    auto getAtlas() -> Font& { return atlas ? *atlas : *this; }
+    auto getAtlas() const -> const Font& { return atlas ? *atlas : *this; }
 };
 using FontPtr = std::shared_ptr<Font>;
-} // namespace lav::core
\ No newline at end of file
+} // namespace lav::core
@@ -1,6 +1,12 @@
 #include "FontLoader.hpp"
+
+#include <algorithm>
+#include <chrono>
+
 #include "src/Core/Binders/GPUBinder.hpp"
 #include "src/Core/ResourceHandler/Font.hpp"
+#include "src/Utils/Misc.hpp"
+#include "src/Utils/Profiler.hpp"
 
 namespace lav::core
 {
@@ -20,13 +26,19 @@ FontLoader::FontLoader()
 
 FontLoader::~FontLoader()
 {
+    for (auto& [_, font] : fontPathToObject_)
+    {
+        if (font->face) { FT_Done_Face(font->face); }
+    }
     FT_Done_FreeType(ftLib_);
     log_.debug("Deallocated.");
 }
 
-FontPtr FontLoader::loadFont(const std::string& fontPath, const int32_t fontSize)
+FontPtr FontLoader::loadFont(const std::string& fontPath, const int32_t fontSize,
+    const Font::RenderMode renderMode)
 {
-    std::string fontKey = fontPath + std::to_string(fontSize);
+    const bool isSdf = renderMode == Font::RenderMode::SDF;
+    std::string fontKey = fontPath + std::to_string(fontSize) + (isSdf ? "sdf" : "");
     if (fontPathToObject_.count(fontKey))
     {
         return fontPathToObject_.at(fontKey);
@@ -44,88 +56,258 @@ FontPtr FontLoader::loadFont(const std::string& fontPath, const int32_t fontSize
     // else { BELoadingQueue::get().pushTask(std::move(task)); }
 
     // fontPathToObject_[fontKey] = futureTask.get();
-    fontPathToObject_[fontKey] = loadFontInternal(fontPath, fontSize);
+    fontPathToObject_[fontKey] = isSdf
+        ? loadSdfFont(fontPath, fontSize)
+        : loadFontInternal(fontPath, fontSize, renderMode);
+    ++stats_.fontsLoaded;
 
     return fontPathToObject_.at(fontKey);
 }
 
-FontPtr FontLoader::loadFontInternal(const std::string& fontPath, const int32_t fontSize)
+auto FontLoader::loadSdfFont(const std::string& fontPath, const int32_t fontSize) -> FontPtr
+{
+    /* All sizes share the face rasterized once at the base size. */
+    const std::string atlasKey = fontPath + "sdf";
+    if (!fontPathToObject_.count(atlasKey))
+    {
+        fontPathToObject_[atlasKey] = loadFontInternal(fontPath, SDF_BASE_SIZE, Font::RenderMode::SDF);
+    }
+
+    FontPtr font = std::make_shared<Font>();
+    font->fontSize = fontSize;
+    font->fontPath = fontPath;
+    font->renderMode = Font::RenderMode::SDF;
+
+    if (fontSize < MIN_FONT_SIZE || fontSize > MAX_FONT_SIZE)
+    {
+        log_.error("Failed to load font: \"{}\". Size is out of bounds: {}.", fontPath, fontSize);
+        return font;
+    }
+
+    font->atlas = fontPathToObject_.at(atlasKey);
+    font->scale = fontSize / static_cast<float>(SDF_BASE_SIZE);
+    font->ascender = font->atlas->ascender * font->scale;
+    font->descender = font->atlas->descender * font->scale;
+    font->lineHeight = font->atlas->lineHeight * font->scale;
+
+    log_.debug("Loaded SDF font with size {} from \"{}\"", fontSize, fontPath);
+
+    return font;
+}
+
+FontPtr FontLoader::loadFontInternal(const std::string& fontPath, const int32_t fontSize,
+    const Font::RenderMode renderMode)
 {
+    LAV_PROFILE_ZONE("FontLoader::loadFont");
+
+    const auto startTime = std::chrono::steady_clock::now();
+
     FontPtr font = std::make_shared<Font>();
     font->fontSize = fontSize;
     font->fontPath = fontPath;
+    font->renderMode = renderMode;
 
     if (fontSize < MIN_FONT_SIZE || fontSize > MAX_FONT_SIZE)
     {
-        log_.error("Failed to load font: \"%s\". Size is out of bounds: %d. Will keep previous font size.",
-            fontPath.c_str(), fontSize);
+        log_.error("Failed to load font: \"{}\". Size is out of bounds: {}.", fontPath, fontSize);
         return font;
     }
 
     FT_Face ftFace;
     if (FT_New_Face(ftLib_, fontPath.c_str(), 0, &ftFace))
     {
-        log_.error("Failed to load font: \"%s\". Will keep previous font.", fontPath.c_str());
+        log_.error("Failed to load font: \"{}\".", fontPath);
         return font;
     }
 
     FT_Set_Pixel_Sizes(ftFace, fontSize, fontSize);
 
-    // /* Generate MAX_GLYPHS levels deep texture. */
-    GPUBinder::get().unpackAlignment();
-    font->textureId = GPUBinder::get().createTexture(
-        fontSize,
-        fontSize,
-        MAX_GLYPHS,
-        GPUBinder::TextureType::Array2D,
-        GPUBinder::ColorType::MONO,
-        GPUBinder::TextureOptions{},
-        nullptr);
+    /* Scaled metrics are in 26.6 fixed point. */
+    const FT_Size_Metrics& metrics = ftFace->size->metrics;
+    font->ascender = metrics.ascender >> 6;
+    font->descender = metrics.descender >> 6;
+    font->lineHeight = metrics.height >> 6;
+
+    /* Face is kept open, glyphs are rasterized only once something actually uses them. */
+    font->face = ftFace;
+    addPage(*font);
+    ++stats_.atlases;
+    stats_.loadTimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    log_.debug("Loaded font with size {} from \"{}\"", fontSize, fontPath);
+
+    return font;
+}
+
+auto FontLoader::getGlyph(Font& font, const uint32_t codepoint) -> const Font::GlyphData&
+{
+    /* Scaled SDF fonts have no glyphs of their own. */
+    Font& atlas = font.getAtlas();
+    if (const auto it = atlas.glyphs.find(codepoint); it != atlas.glyphs.end()) { return it->second; }
+
+    /* Failures are cached as well so we don't retry them on each use. */
+    const auto startTime = std::chrono::steady_clock::now();
+    const auto& glyph = atlas.glyphs.emplace(codepoint, rasterizeGlyph(atlas, codepoint)).first->second;
+    stats_.loadTimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    return glyph;
+}
+
+auto FontLoader::rasterizeGlyph(Font& font, const uint32_t codepoint) -> Font::GlyphData
+{
+    LAV_PROFILE_ZONE("FontLoader::rasterizeGlyph");
 
-    if (!font->textureId)
+    Font::GlyphData glyph{.codepoint = codepoint};
+    const bool isSdf = font.renderMode == Font::RenderMode::SDF;
+    if (!font.face || FT_Load_Char(font.face, codepoint, isSdf ? FT_LOAD_DEFAULT : FT_LOAD_RENDER))
     {
-        log_.error("Texture Id returned is zero!");
-        return font;
+        log_.error("Error loading char code: {}", codepoint);
+        return glyph;
     }
 
-    GPUBinder::get().bindIdToTextureType(GPUBinder::TextureType::Array2D, font->textureId);
+    const FT_GlyphSlot slot = font.face->glyph;
+    glyph.hAdvance = slot->advance.x;
+    ++stats_.glyphsRasterized;
 
-    FT_Int32 load_flags = FT_LOAD_RENDER;
-    for (int32_t i = 32; i < MAX_GLYPHS; i++)
+    /* Outlines with no contours (whitespace) have nothing to turn into a distance field. */
+    if (isSdf && slot->outline.n_contours > 0 && FT_Render_Glyph(slot, FT_RENDER_MODE_SDF))
     {
-        /* Loads i'th char in font atlas */
-        if (FT_Load_Char(ftFace, i, load_flags))
+        log_.error("Error rendering SDF for char code: {}", codepoint);
+        return glyph;
+    }
+    if (slot->format != FT_GLYPH_FORMAT_BITMAP) { return glyph; }
+
+    const FT_Bitmap& bitmap = slot->bitmap;
+    glyph.size = glm::ivec2(bitmap.width, bitmap.rows);
+    glyph.bearing = glm::ivec2(slot->bitmap_left, slot->bitmap_top);
+
+    /* Whitespace only advances the pen. */
+    if (glyph.size.x == 0 || glyph.size.y == 0) { return glyph; }
+
+    std::optional<glm::ivec2> pos = font.packer.pack(glyph.size);
+    if (!pos)
+    {
+        /* Current page is full, continue on a fresh one. */
+        font.packer.reset();
+        addPage(font);
+        pos = font.packer.pack(glyph.size);
+    }
+
+    if (!pos)
+    {
+        log_.error("Glyph {} of size {}x{} doesn't fit in an atlas page", codepoint, glyph.size.x, glyph.size.y);
+        return glyph;
+    }
+
+    /* Bitmap rows can be padded (pitch), copy them one by one. */
+    auto& page = font.pages.back();
+    for (int32_t row = 0; row < glyph.size.y; ++row)
+    {
+        const uint8_t* src = bitmap.buffer + row * bitmap.pitch;
+        std::copy_n(src, glyph.size.x, page.pixels.begin() + (pos->y + row) * ATLAS_PAGE_SIZE + pos->x);
+    }
+
+    page.dirtyRect = utils::rectUnion(page.dirtyRect, {pos.value(), glyph.size});
+    font.hasPendingUploads = true;
+
+    glyph.uvRect = glm::vec4{pos.value(), glyph.size} / static_cast<float>(ATLAS_PAGE_SIZE);
+    glyph.page = font.pages.size() - 1;
+
+    return glyph;
+}
+
+auto FontLoader::addPage(Font& font) -> void
+{
+    font.pages.emplace_back(Font::AtlasPage{
+        .pixels = std::vector<uint8_t>(ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE, 0),
+        .dirtyRect = {0, 0, 0, 0}});
+    stats_.cpuAtlasBytes += ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE;
+}
+
+auto FontLoader::getStats() const -> const Stats& { return stats_; }
+
+auto FontLoader::releaseUnused() -> uint32_t
+{
+    uint32_t released{0};
+
+    /* Sized SDF fonts hold their shared atlas, releasing them can free the atlas on the next pass. */
+    while (true)
+    {
+        const auto count = std::erase_if(fontPathToObject_, [this](const auto& entry)
         {
-            log_.error("Error loading char code: %d", i);
-            continue;
-        }
+            const FontPtr& font = entry.second;
+            if (font.use_count() > 1) { return false; }
+
+            GPUBinder::get().deleteTexture(font->textureId);
+            if (font->face) { FT_Done_Face(font->face); }
+            stats_.gpuAtlasBytes -= font->texturePages * ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE;
+            stats_.cpuAtlasBytes -= font->pages.size() * ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE;
+            log_.debug("Released font with size {} from \"{}\"", font->fontSize, font->fontPath);
+            return true;
+        });
+        if (!count) { break; }
+        released += count;
+    }
+
+    return released;
+}
 
-        GPUBinder::get().bufferTextureData(
-            ftFace->glyph->bitmap.width,
-            ftFace->glyph->bitmap.rows,
-            i,
+auto FontLoader::uploadPendingGlyphs() -> void
+{
+    for (auto& [_, font] : fontPathToObject_)
+    {
+        if (font->hasPendingUploads) { uploadPages(*font); }
+    }
+}
+
+auto FontLoader::uploadPages(Font& font) -> void
+{
+    LAV_PROFILE_ZONE("FontLoader::uploadPages");
+
+    auto& gpuBinder = GPUBinder::get();
+
+    /* Out of layers. Grow the texture and send everything again, pages are small. */
+    if (font.texturePages < font.pages.size())
+    {
+        gpuBinder.deleteTexture(font.textureId);
+        stats_.gpuAtlasBytes -= font.texturePages * ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE;
+        font.texturePages = std::max<uint32_t>(font.pages.size(), font.texturePages * 2);
+        font.textureId = gpuBinder.createTexture(
+            ATLAS_PAGE_SIZE,
+            ATLAS_PAGE_SIZE,
+            font.texturePages,
             GPUBinder::TextureType::Array2D,
             GPUBinder::ColorType::MONO,
-            ftFace->glyph->bitmap.buffer);
+            GPUBinder::TextureOptions{},
+            nullptr);
 
-        Font::GlyphData ch =
+        if (!font.textureId)
         {
-            .glyphCode = uint32_t(i),
-            .hAdvance = ftFace->glyph->advance.x,
-            .size = glm::ivec2(ftFace->glyph->bitmap_left + ftFace->glyph->bitmap.width,
-                ftFace->glyph->bitmap_top + ftFace->glyph->bitmap.rows),
-            .bearing = glm::ivec2(ftFace->glyph->bitmap_left, ftFace->glyph->bitmap_top)
-        };
+            log_.error("Texture Id returned is zero!");
+            font.texturePages = 0;
+            return;
+        }
+        stats_.gpuAtlasBytes += font.texturePages * ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE;
 
-        font->glyphData[i] = ch;
+        for (auto& page : font.pages) { page.dirtyRect = {0, 0, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE}; }
+        log_.debug("Font \"{}\" size {} atlas now has {} pages", font.fontPath, font.fontSize, font.texturePages);
     }
 
-    log_.debug("Loaded font texture {} with size {} from \"{}\"", font->textureId, fontSize, fontPath);
+    gpuBinder.unpackAlignment();
+    gpuBinder.bindIdToTextureType(GPUBinder::TextureType::Array2D, font.textureId);
+    for (uint32_t i = 0; i < font.pages.size(); ++i)
+    {
+        auto& page = font.pages[i];
+        if (page.dirtyRect.z <= 0 || page.dirtyRect.w <= 0) { continue; }
 
-    /* Unbind texture and free FreeType resources */
-    GPUBinder::get().bindIdToTextureType(GPUBinder::TextureType::Array2D, 0);
-    FT_Done_Face(ftFace);
+        gpuBinder.bufferTextureSubData(page.dirtyRect, i, ATLAS_PAGE_SIZE,
+            GPUBinder::TextureType::Array2D, GPUBinder::ColorType::MONO, page.pixels.data());
+        page.dirtyRect = glm::ivec4{0};
+    }
+    gpuBinder.bindIdToTextureType(GPUBinder::TextureType::Array2D, 0);
 
-    return font;
+    font.hasPendingUploads = false;
 }
-} // namespace lav::core
\ No newline at end of file
+} // namespace lav::core
@@ -12,16 +12,70 @@ namespace lav::core
 {
 class FontLoader
 {
+public:
+    /** @brief Counters to compare the cost of the render modes. */
+    struct Stats
+    {
+        uint32_t fontsLoaded{0};
+        uint32_t atlases{0};
+        uint64_t glyphsRasterized{0};
+        uint64_t loadTimeNs{0};      /* Opening faces plus rasterizing glyphs */
+        uint64_t cpuAtlasBytes{0};   /* Pages kept on the CPU side */
+        uint64_t gpuAtlasBytes{0};   /* Texture storage currently allocated */
+    };
+
 public:
     static FontLoader& get();
 
-    FontPtr loadFont(const std::string& fontPath, const int32_t fontSize = 16);
+    /**
+        @brief Load a font at a given size.
+
+        @note SDF fonts of the same face share one atlas regardless of size, so loading more sizes only
+            costs a small Font object.
+
+        @param fontPath Path to the font file
+        @param fontSize Size in pixels
+        @param renderMode How glyphs get rasterized
+
+        @return Loaded font. Cached, so loading it again is cheap.
+    */
+    FontPtr loadFont(const std::string& fontPath, const int32_t fontSize = 16,
+        const Font::RenderMode renderMode = Font::RenderMode::BITMAP);
+
+    /**
+        @brief Get the glyph of a codepoint, rasterizing it into the font's atlas if it's the first use.
+
+        @note New glyphs only reach the GPU after the next uploadPendingGlyphs().
+
+        @param font Font to get the glyph from
+        @param codepoint Unicode codepoint of the glyph
+
+        @return Glyph data. Codepoints missing from the face get the face's fallback glyph.
+    */
+    auto getGlyph(Font& font, const uint32_t codepoint) -> const Font::GlyphData&;
+
+    /** @brief Upload to the GPU every glyph rasterized since the last call. One upload per dirty page. */
+    auto uploadPendingGlyphs() -> void;
+
+    auto getStats() const -> const Stats&;
+
+    /**
+        @brief Release every font nothing uses anymore, freeing its atlas and face.
+
+        @return Number of fonts released.
+    */
+    auto releaseUnused() -> uint32_t;
 
 private:
     FontLoader();
     ~FontLoader();
 
-    FontPtr loadFontInternal(const std::string& fontPath, const int32_t fontSize);
+    FontPtr loadFontInternal(const std::string& fontPath, const int32_t fontSize,
+        const Font::RenderMode renderMode);
+    auto loadSdfFont(const std::string& fontPath, const int32_t fontSize) -> FontPtr;
+    auto addPage(Font& font) -> void;
+    auto rasterizeGlyph(Font& font, const uint32_t codepoint) -> Font::GlyphData;
+    auto uploadPages(Font& font) -> void;
 
     /* Cannot be copied or moved */
     FontLoader(const FontLoader&) = delete;
@@ -34,5 +88,6 @@ private:
     FT_Library ftLib_;
 
     std::unordered_map<std::string, FontPtr> fontPathToObject_;
+    Stats stats_;
 };
-} // namespace lav::core
\ No newline at end of file
+} // namespace lav::core
@@ -0,0 +1,145 @@
+#include "LoadingQueue.hpp"
+
+#include "src/Utils/Profiler.hpp"
+
+namespace lav::core
+{
+auto LoadingQueue::get() -> LoadingQueue&
+{
+    static LoadingQueue instance;
+    return instance;
+}
+
+LoadingQueue::LoadingQueue()
+    : mainThreadId_(std::this_thread::get_id())
+{
+    /* Created before the workers so it also outlives them, they record until joined. */
+    utils::Profiler::get().setThreadName("main");
+
+    /* Leave a core for the UI thread. Core count may be unknown (0). */
+    const uint32_t hwThreads = std::thread::hardware_concurrency();
+    const uint32_t workersCount = hwThreads > 1 ? hwThreads - 1 : 1;
+    workers_.reserve(workersCount);
+    for (uint32_t i = 0; i < workersCount; ++i)
+    {
+        workers_.emplace_back([this, i](std::stop_token stopToken)
+        {
+            utils::Profiler::get().setThreadName("loader " + std::to_string(i));
+            workerLoop(stopToken);
+        });
+    }
+    log_.debug("Started {} loading workers", workersCount);
+}
+
+LoadingQueue::~LoadingQueue()
+{
+    /* Jobs still queued are dropped, the workers only finish what they're running. */
+    for (auto& worker : workers_) { worker.request_stop(); }
+    jobsCv_.notify_all();
+    workers_.clear();
+    log_.debug("Deallocated.");
+}
+
+auto LoadingQueue::pushJob(Job job) -> void
+{
+    {
+        std::scoped_lock lock{jobsMutex_};
+        jobs_.emplace_back(std::move(job));
+        ++stats_.jobsQueued;
+    }
+    jobsCv_.notify_one();
+}
+
+auto LoadingQueue::pushUpload(Job upload) -> void
+{
+    std::scoped_lock lock{uploadsMutex_};
+    uploads_.emplace_back(std::move(upload));
+
+    /* Under the lock so the notifier can't be swapped out mid call. */
+    if (uploadNotifier_) { uploadNotifier_(); }
+}
+
+auto LoadingQueue::drainUploads(const std::chrono::microseconds budget) -> uint32_t
+{
+    LAV_PROFILE_ZONE("LoadingQueue::drainUploads");
+
+    const auto startTime = std::chrono::steady_clock::now();
+    uint32_t uploadsDone{0};
+    while (true)
+    {
+        Job upload;
+        {
+            std::scoped_lock lock{uploadsMutex_};
+            if (uploads_.empty()) { break; }
+
+            if (uploadsDone && std::chrono::steady_clock::now() - startTime >= budget)
+            {
+                ++stats_.drainsOverBudget;
+                break;
+            }
+
+            upload = std::move(uploads_.front());
+            uploads_.pop_front();
+            ++stats_.uploadsDone;
+        }
+
+        /* Run unlocked, uploads are allowed to queue more work. */
+        upload();
+        ++uploadsDone;
+    }
+
+    return uploadsDone;
+}
+
+auto LoadingQueue::setUploadNotifier(Job onUploadQueued) -> void
+{
+    std::scoped_lock lock{uploadsMutex_};
+    uploadNotifier_ = std::move(onUploadQueued);
+}
+
+auto LoadingQueue::hasPendingUploads() const -> bool
+{
+    std::scoped_lock lock{uploadsMutex_};
+    return !uploads_.empty();
+}
+
+auto LoadingQueue::hasPendingWork() const -> bool
+{
+    {
+        std::scoped_lock lock{jobsMutex_};
+        if (!jobs_.empty() || jobsRunning_) { return true; }
+    }
+    std::scoped_lock lock{uploadsMutex_};
+    return !uploads_.empty();
+}
+
+auto LoadingQueue::isThisMainThread() const -> bool { return std::this_thread::get_id() == mainThreadId_; }
+
+auto LoadingQueue::getStats() const -> Stats
+{
+    std::scoped_lock lock{jobsMutex_, uploadsMutex_};
+    return stats_;
+}
+
+auto LoadingQueue::workerLoop(std::stop_token stopToken) -> void
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock lock{jobsMutex_};
+            if (!jobsCv_.wait(lock, stopToken, [this] { return !jobs_.empty(); })) { return; }
+
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+            ++jobsRunning_;
+        }
+
+        job();
+
+        std::scoped_lock lock{jobsMutex_};
+        --jobsRunning_;
+        ++stats_.jobsDone;
+    }
+}
+} // namespace lav::core
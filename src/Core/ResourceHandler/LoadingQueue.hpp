@@ -0,0 +1,108 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "src/Utils/Logger.hpp"
+
+namespace lav::core
+{
+/**
+    @brief Worker pool for resource loading. File I/O and CPU decoding run on the workers, anything touching
+        GL is handed back to the context thread and drained there under a time budget.
+
+    @note Uploads are drained by each UIWindow at the start of its frame. All windows share one context so
+        it doesn't matter which window ends up doing the upload.
+*/
+class LoadingQueue
+{
+public:
+    using Job = std::function<void()>;
+
+    struct Stats
+    {
+        uint64_t jobsQueued{0};
+        uint64_t jobsDone{0};
+        uint64_t uploadsDone{0};
+        uint64_t drainsOverBudget{0}; /* Drains that stopped with uploads still left */
+    };
+
+public:
+    static auto get() -> LoadingQueue&;
+
+    /**
+        @brief Run a job on one of the workers. Must not touch GL.
+
+        @param job Job to run
+    */
+    auto pushJob(Job job) -> void;
+
+    /**
+        @brief Queue work that needs the GL context. Can be called from any thread.
+
+        @param upload Work to run on the context thread
+    */
+    auto pushUpload(Job upload) -> void;
+
+    /**
+        @brief Run queued uploads until the budget is spent. At least one upload runs per call so progress
+            is always made.
+
+        @note Needs to be called on the context thread.
+
+        @param budget Time allowed for uploads
+
+        @return Number of uploads ran.
+    */
+    auto drainUploads(const std::chrono::microseconds budget) -> uint32_t;
+
+    /**
+        @brief Set what gets called each time an upload is queued, i.e to wake up a sleeping render loop.
+
+        @note Runs on the thread queueing the upload.
+
+        @param onUploadQueued Function to call. Empty to stop notifying
+    */
+    auto setUploadNotifier(Job onUploadQueued) -> void;
+
+    auto hasPendingWork() const -> bool;
+    auto hasPendingUploads() const -> bool;
+    auto isThisMainThread() const -> bool;
+    auto getStats() const -> Stats;
+
+private:
+    LoadingQueue();
+    ~LoadingQueue();
+
+    auto workerLoop(std::stop_token stopToken) -> void;
+
+    /* Cannot be copied or moved */
+    LoadingQueue(const LoadingQueue&) = delete;
+    LoadingQueue(LoadingQueue&&) = delete;
+    LoadingQueue& operator=(const LoadingQueue&) = delete;
+    LoadingQueue& operator=(LoadingQueue&&) = delete;
+
+private:
+    utils::Logger log_{"LoadingQueue"};
+    std::thread::id mainThreadId_;
+
+    mutable std::mutex jobsMutex_;
+    std::condition_variable_any jobsCv_;
+    std::deque<Job> jobs_;
+    uint32_t jobsRunning_{0};
+
+    mutable std::mutex uploadsMutex_;
+    std::deque<Job> uploads_;
+    Job uploadNotifier_;
+
+    Stats stats_;
+    std::vector<std::jthread> workers_;
+};
+} // namespace lav::core
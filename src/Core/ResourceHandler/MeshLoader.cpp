@@ -18,6 +18,30 @@ auto MeshLoader::loadQuad() -> uint32_t
         return vaos_.at("q");
     }
 
+    uint32_t vaoId = createQuad();
+
+    log_.debug("Loaded quad mesh with vaoID {}", vaoId);
+    vaos_["q"] = vaoId;
+
+    return vaoId;
+}
+
+auto MeshLoader::loadInstancedQuad(const uint32_t instanceBufferId,
+    const std::vector<uint32_t>& instanceComponentsSize) -> uint32_t
+{
+    /* Not cached. Each instance buffer needs it's own vao to describe it. */
+    uint32_t vaoId = createQuad();
+
+    /* Locations 0 and 1 are taken by the quad itself. */
+    GPUBinder::get().attachInstanceBuffer(vaoId, instanceBufferId, 2, instanceComponentsSize);
+
+    log_.debug("Loaded instanced quad mesh with vaoID {} for buffer {}", vaoId, instanceBufferId);
+
+    return vaoId;
+}
+
+auto MeshLoader::createQuad() -> uint32_t
+{
     /* Note: clockwise winding */
     std::vector<float> vertexData =
     {
@@ -36,12 +60,7 @@ auto MeshLoader::loadQuad() -> uint32_t
 
     std::vector<uint32_t> eboComponentsSize = { 3, 2 };
 
-    uint32_t vaoId = GPUBinder::get().loadMeshData(vertexData, eboData, eboComponentsSize);
-
-    log_.debug("Loaded quad mesh with vaoID {}", vaoId);
-    vaos_["q"] = vaoId;
-
-    return vaoId;
+    return GPUBinder::get().loadMeshData(vertexData, eboData, eboComponentsSize);
 }
 
 auto MeshLoader::get() -> MeshLoader&
@@ -49,4 +68,4 @@ auto MeshLoader::get() -> MeshLoader&
     static MeshLoader instance;
     return instance;
 }
-} // namespace lav::core
\ No newline at end of file
+} // namespace lav::core
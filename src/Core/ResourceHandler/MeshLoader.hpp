@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <unordered_map>
+#include <vector>
 
 #include "src/Utils/Logger.hpp"
 
@@ -11,6 +12,8 @@ class MeshLoader
 {
 public:
     auto loadQuad() -> uint32_t;
+    auto loadInstancedQuad(const uint32_t instanceBufferId,
+        const std::vector<uint32_t>& instanceComponentsSize) -> uint32_t;
 
 public:
     static auto get() -> MeshLoader&;
@@ -23,6 +26,8 @@ private:
     MeshLoader& operator=(const MeshLoader&) = delete;
     MeshLoader& operator=(MeshLoader&&) = delete;
 
+    auto createQuad() -> uint32_t;
+
 private:
     utils::Logger log_;
     std::unordered_map<std::string, uint32_t> vaos_;
@@ -0,0 +1,107 @@
+#include "ResidencyManager.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "src/Core/ResourceHandler/FontLoader.hpp"
+#include "src/Core/ResourceHandler/TextureLoader.hpp"
+
+namespace lav::core
+{
+auto ResidencyManager::get() -> ResidencyManager&
+{
+    static ResidencyManager instance;
+    return instance;
+}
+
+auto ResidencyManager::beginFrame() -> void { ++frame_; }
+
+auto ResidencyManager::enforceBudget() -> void
+{
+    std::vector<TexturePtr> candidates;
+    uint64_t textureBytes{0};
+    stats_.residentTextures = 0;
+    for (auto it = textures_.begin(); it != textures_.end();)
+    {
+        TexturePtr texture = it->second.lock();
+        if (!texture)
+        {
+            it = textures_.erase(it);
+            continue;
+        }
+
+        if (texture->state == Texture::State::RESIDENT)
+        {
+            textureBytes += texture->gpuBytes;
+            ++stats_.residentTextures;
+
+            /* Secondary windows render after the main one, so the previous frame is still in use. Atlased
+                ones are accounted for by their pages, evicting them frees nothing. */
+            const bool isStale = texture->lastUsedFrame + 1 < frame_;
+            if (isStale && !texture->isAtlased && !texture->isPinned) { candidates.emplace_back(std::move(texture)); }
+        }
+        ++it;
+    }
+
+    const auto sharedBytes = []
+    {
+        return FontLoader::get().getStats().gpuAtlasBytes + TextureLoader::get().getAtlasBytes();
+    };
+    stats_.residentBytes = textureBytes + sharedBytes();
+    if (stats_.residentBytes <= stats_.budgetBytes) { return; }
+
+    /* Fonts nobody uses are the cheapest to give up. */
+    if (FontLoader::get().releaseUnused()) { stats_.residentBytes = textureBytes + sharedBytes(); }
+
+    std::ranges::sort(candidates, {}, &Texture::lastUsedFrame);
+    for (const auto& texture : candidates)
+    {
+        if (stats_.residentBytes <= stats_.budgetBytes) { break; }
+
+        /* One reference is the loader's cache, the other one is ours. */
+        const bool isReferenced = texture.use_count() > 2;
+        const uint64_t gpuBytes = texture->gpuBytes;
+        if (!TextureLoader::get().unload(texture, isReferenced)) { continue; }
+
+        stats_.residentBytes -= gpuBytes;
+        --stats_.residentTextures;
+        ++stats_.evictions;
+    }
+
+    if (stats_.residentBytes > stats_.budgetBytes)
+    {
+        log_.debug("Still over budget after evicting: {} of {} bytes", stats_.residentBytes, stats_.budgetBytes);
+    }
+}
+
+auto ResidencyManager::track(const TexturePtr& texture) -> void
+{
+    if (!texture) { return; }
+
+    texture->lastUsedFrame = frame_;
+    textures_[texture.get()] = texture;
+}
+
+auto ResidencyManager::touch(const TexturePtr& texture, ReloadCallback onReload) -> bool
+{
+    if (!texture) { return false; }
+
+    texture->lastUsedFrame = frame_;
+    if (texture->state == Texture::State::RESIDENT)
+    {
+        ++stats_.hits;
+        return true;
+    }
+
+    if (texture->state == Texture::State::EVICTED)
+    {
+        ++stats_.misses;
+        TextureLoader::get().reload(texture, std::move(onReload));
+    }
+
+    return false;
+}
+
+auto ResidencyManager::setBudget(const uint64_t bytes) -> void { stats_.budgetBytes = bytes; }
+auto ResidencyManager::getStats() const -> const Stats& { return stats_; }
+} // namespace lav::core
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+#include "src/Core/ResourceHandler/Texture.hpp"
+#include "src/Utils/Logger.hpp"
+
+namespace lav::core
+{
+/**
+    @brief Keeps the GPU memory used by textures and fonts under a budget.
+
+    @note Textures from TextureLoader are tracked. When over budget, the least recently rendered loadAsync
+        ones are evicted first: dropped completely if nothing references them anymore, otherwise their GPU
+        storage is freed and they reload transparently the next time they're touched. Synchronously loaded
+        ones are only counted.
+    @note Fonts and image atlas pages are only counted. Unreferenced fonts get released when over budget,
+        atlas pages never are.
+    @note Anything rendered during the current or the previous frame is never evicted. Only frames that
+        render count, and visible nodes left out of a partial redraw keep their textures too.
+    @note Textures packed into an image atlas page are never evicted, the page is what holds the memory.
+*/
+class ResidencyManager
+{
+public:
+    using ReloadCallback = std::function<void(const TexturePtr&)>;
+
+    struct Stats
+    {
+        uint64_t budgetBytes{0};
+        uint64_t residentBytes{0};
+        uint32_t residentTextures{0};
+        uint64_t hits{0};      /* Touched while resident */
+        uint64_t misses{0};    /* Touched while evicted, triggering a reload */
+        uint64_t evictions{0};
+    };
+
+public:
+    static auto get() -> ResidencyManager&;
+
+    /** @brief Start a new frame. Called by the main window only. */
+    auto beginFrame() -> void;
+
+    /** @brief Evict until back under budget. Called by the main window once per run, before rendering. */
+    auto enforceBudget() -> void;
+
+    /**
+        @brief Start tracking a texture that just became resident.
+
+        @param texture Texture to track. Tracking is weak, it doesn't keep the texture alive
+    */
+    auto track(const TexturePtr& texture) -> void;
+
+    /**
+        @brief Mark a texture as used by the current frame.
+
+        @param texture Texture about to be rendered
+        @param onReload Called once the texture is resident again, if it had to be reloaded
+
+        @return True if the texture is resident and can be rendered right away.
+    */
+    auto touch(const TexturePtr& texture, ReloadCallback onReload = {}) -> bool;
+
+    auto setBudget(const uint64_t bytes) -> void;
+    auto getStats() const -> const Stats&;
+
+private:
+    ResidencyManager() = default;
+    ~ResidencyManager() = default;
+
+    /* Cannot be copied or moved */
+    ResidencyManager(const ResidencyManager&) = delete;
+    ResidencyManager(ResidencyManager&&) = delete;
+    ResidencyManager& operator=(const ResidencyManager&) = delete;
+    ResidencyManager& operator=(ResidencyManager&&) = delete;
+
+private:
+    utils::Logger log_{"ResidencyManager"};
+    std::unordered_map<const Texture*, std::weak_ptr<Texture>> textures_;
+    uint64_t frame_{2};
+    Stats stats_{.budgetBytes = 512ull * 1024 * 1024};
+};
+} // namespace lav::core
@@ -7,9 +7,63 @@ namespace lav::core
 {
 Shader::Shader(const uint32_t programId)
     : programId_(programId)
-{}
+{
+    /* Not all programs use all the slots. Missing ones will be -1 and uploading to them is a no-op. */
+    locations_.fill(-1);
+    if (!programId_) { return; }
+
+    for (uint8_t i = 0; i < locations_.size(); ++i)
+    {
+        locations_[i] = GPUBinder::get().getUniformLocation(programId_, uniformNames[i]);
+    }
+}
+
+auto Shader::uploadMat4(const Uniform slot, const glm::mat4& val) const -> void
+{
+    GPUBinder::get().uploadUniform(getLocation(slot), val);
+}
+
+auto Shader::uploadMat4v(const Uniform slot, const std::vector<glm::mat4>& vals) const -> void
+{
+    GPUBinder::get().uploadUniform(getLocation(slot), vals);
+}
 
-auto Shader::uploadMat4(const std::string& name, const glm::mat4& val) const -> void
+auto Shader::uploadVec2f(const Uniform slot, const glm::vec2& val) const -> void
+{
+    GPUBinder::get().uploadUniform(getLocation(slot), val);
+}
+
+auto Shader::uploadVec4f(const Uniform slot, const glm::vec4& val) const -> void
+{
+    GPUBinder::get().uploadUniform(getLocation(slot), val);
+}
+
+auto Shader::uploadVec4fv(const Uniform slot, const std::vector<glm::vec4>& vals) const -> void
+{
+    GPUBinder::get().uploadUniform(getLocation(slot), vals);
+}
+
+auto Shader::uploadInt(const Uniform slot, const int32_t val) const -> void
+{
+    GPUBinder::get().uploadUniform(getLocation(slot), val);
+}
+
+auto Shader::uploadIntv(const Uniform slot, const std::vector<int32_t>& val) const -> void
+{
+    GPUBinder::get().uploadUniform(getLocation(slot), val);
+}
+
+auto Shader::uploadTexture2D(const Uniform slot, const uint32_t texSlot, const uint32_t texId) const -> void
+{
+    GPUBinder::get().uploadUniformTexture(getLocation(slot), GPUBinder::TextureType::Single2D, texSlot, texId);
+}
+
+auto Shader::uploadTexture2DArray(const Uniform slot, const uint32_t texSlot, const uint32_t texId) const -> void
+{
+    GPUBinder::get().uploadUniformTexture(getLocation(slot), GPUBinder::TextureType::Array2D, texSlot, texId);
+}
+
+auto Shader::uploadMat4(const std::string_view name, const glm::mat4& val) const -> void
 {
     reportFailure(
         name,
@@ -17,7 +71,7 @@ auto Shader::uploadMat4(const std::string& name, const glm::mat4& val) const ->
     );
 }
 
-auto Shader::uploadMat4v(const std::string& name, const std::vector<glm::mat4>& vals) const -> void
+auto Shader::uploadMat4v(const std::string_view name, const std::vector<glm::mat4>& vals) const -> void
 {
     reportFailure(
         name,
@@ -25,7 +79,7 @@ auto Shader::uploadMat4v(const std::string& name, const std::vector<glm::mat4>&
     );
 }
 
-auto Shader::uploadVec2f(const std::string& name, const glm::vec2& val) const -> void
+auto Shader::uploadVec2f(const std::string_view name, const glm::vec2& val) const -> void
 {
     reportFailure(
         name,
@@ -33,7 +87,7 @@ auto Shader::uploadVec2f(const std::string& name, const glm::vec2& val) const ->
     );
 }
 
-auto Shader::uploadVec4f(const std::string& name, const glm::vec4& val) const -> void
+auto Shader::uploadVec4f(const std::string_view name, const glm::vec4& val) const -> void
 {
     reportFailure(
         name,
@@ -41,7 +95,7 @@ auto Shader::uploadVec4f(const std::string& name, const glm::vec4& val) const ->
     );
 }
 
-auto Shader::uploadInt(const std::string& name, const int32_t val) const -> void
+auto Shader::uploadInt(const std::string_view name, const int32_t val) const -> void
 {
     reportFailure(
         name,
@@ -49,7 +103,7 @@ auto Shader::uploadInt(const std::string& name, const int32_t val) const -> void
     );
 }
 
-auto Shader::uploadIntv(const std::string& name, const std::vector<int32_t>& val) const -> void
+auto Shader::uploadIntv(const std::string_view name, const std::vector<int32_t>& val) const -> void
 {
     reportFailure(
         name,
@@ -57,7 +111,7 @@ auto Shader::uploadIntv(const std::string& name, const std::vector<int32_t>& val
     );
 }
 
-auto Shader::uploadTexture2D(const std::string& name, const uint32_t texSlot,
+auto Shader::uploadTexture2D(const std::string_view name, const uint32_t texSlot,
     const uint32_t texId) const -> void
 {
     reportFailure(
@@ -67,7 +121,7 @@ auto Shader::uploadTexture2D(const std::string& name, const uint32_t texSlot,
     );
 }
 
-auto Shader::uploadTexture2DArray(const std::string& name, const uint32_t texSlot,
+auto Shader::uploadTexture2DArray(const std::string_view name, const uint32_t texSlot,
     const uint32_t texId) const -> void
 {
     reportFailure(
@@ -77,12 +131,13 @@ auto Shader::uploadTexture2DArray(const std::string& name, const uint32_t texSlo
     );
 }
 
-auto Shader::reportFailure(const std::string& name, const bool success) const -> void
+auto Shader::reportFailure(const std::string_view name, const bool success) const -> void
 {
     if (success) { return; }
 
-    utils::Logger log("Shader({})", programId_);
-    log.warn("Can't find location named: '{}'", name);
+    /* Shared logger instead of constructing one on each failure. */
+    static const utils::Logger log("Shader");
+    log.warn("Program {} can't find location named: '{}'", programId_, name);
 }
 
 auto Shader::bind() const -> void { GPUBinder::get().useProgram(programId_); }
@@ -90,4 +145,9 @@ auto Shader::bind() const -> void { GPUBinder::get().useProgram(programId_); }
 auto Shader::unbind() const -> void { GPUBinder::get().useProgram(0); }
 
 auto Shader::getId() const -> uint32_t { return programId_; }
-} // namespace lav::core
\ No newline at end of file
+
+auto Shader::getLocation(const Uniform slot) const -> int32_t
+{
+    return locations_[static_cast<uint8_t>(slot)];
+}
+} // namespace lav::core
@@ -1,13 +1,54 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "src/Utils/Logger.hpp"
 #include "vendor/glm/glm.hpp"
 
 namespace lav::core
 {
+/**
+    @brief Uniforms used by the engine's own shaders. Locations of these are resolved once when the
+        Shader is created so uploading them doesn't involve any string handling.
+
+    @note Needs to be kept in sync with @ref `uniformNames`.
+*/
+enum class Uniform : uint8_t
+{
+    MATRIX_PROJECTION,
+    MATRIX_TRANSFORM,
+    COLOR,
+    BORDER_COLOR,
+    BORDER_SIZE,
+    BORDER_RADII,
+    RESOLUTION,
+    USE_TEXTURE,
+    TEXTURE,
+    TEXTURE_ARRAY,
+    SDF,
+    COUNT
+};
+
+/** @brief Compile time name table for each @ref `Uniform` slot. */
+inline constexpr std::array<std::string_view, static_cast<uint8_t>(Uniform::COUNT)> uniformNames
+{
+    "uMatrixProjection",
+    "uMatrixTransform",
+    "uColor",
+    "uBorderColor",
+    "uBorderSize",
+    "uBorderRadii",
+    "uResolution",
+    "uUseTexture",
+    "uTexture",
+    "uTextureArray",
+    "uSdf"
+};
+
 class Shader
 {
 public:
@@ -17,25 +58,39 @@ public:
     Shader& operator=(const Shader&) = default;
     Shader& operator=(Shader&&) = delete;
 
-    auto uploadMat4(const std::string& name, const glm::mat4& val) const -> void;
-    auto uploadMat4v(const std::string& name, const std::vector<glm::mat4>& vals) const -> void;
-    auto uploadVec2f(const std::string& name, const glm::vec2& val) const -> void;
-    auto uploadVec4f(const std::string& name, const glm::vec4& val) const -> void;
-    auto uploadInt(const std::string& name, const int32_t val) const -> void;
-    auto uploadIntv(const std::string& name, const std::vector<int32_t>& val) const -> void;
-    auto uploadTexture2D(const std::string& name, const uint32_t texSlot,
+    /* Slot based uploads. Preferred in hot paths. */
+    auto uploadMat4(const Uniform slot, const glm::mat4& val) const -> void;
+    auto uploadMat4v(const Uniform slot, const std::vector<glm::mat4>& vals) const -> void;
+    auto uploadVec2f(const Uniform slot, const glm::vec2& val) const -> void;
+    auto uploadVec4f(const Uniform slot, const glm::vec4& val) const -> void;
+    auto uploadVec4fv(const Uniform slot, const std::vector<glm::vec4>& vals) const -> void;
+    auto uploadInt(const Uniform slot, const int32_t val) const -> void;
+    auto uploadIntv(const Uniform slot, const std::vector<int32_t>& val) const -> void;
+    auto uploadTexture2D(const Uniform slot, const uint32_t texSlot, const uint32_t texId) const -> void;
+    auto uploadTexture2DArray(const Uniform slot, const uint32_t texSlot, const uint32_t texId) const -> void;
+
+    /* Name based uploads. Locations are still cached per program by the GPUBinder. */
+    auto uploadMat4(const std::string_view name, const glm::mat4& val) const -> void;
+    auto uploadMat4v(const std::string_view name, const std::vector<glm::mat4>& vals) const -> void;
+    auto uploadVec2f(const std::string_view name, const glm::vec2& val) const -> void;
+    auto uploadVec4f(const std::string_view name, const glm::vec4& val) const -> void;
+    auto uploadInt(const std::string_view name, const int32_t val) const -> void;
+    auto uploadIntv(const std::string_view name, const std::vector<int32_t>& val) const -> void;
+    auto uploadTexture2D(const std::string_view name, const uint32_t texSlot,
         const uint32_t texId) const -> void;
-    auto uploadTexture2DArray(const std::string& name, const uint32_t texSlot,
+    auto uploadTexture2DArray(const std::string_view name, const uint32_t texSlot,
         const uint32_t texId) const -> void;
 
     auto bind() const -> void;
     auto unbind() const -> void;
     auto getId() const -> uint32_t;
+    auto getLocation(const Uniform slot) const -> int32_t;
 
 private:
-    auto reportFailure(const std::string& name, const bool success) const -> void;
+    auto reportFailure(const std::string_view name, const bool success) const -> void;
 
 private:
     uint32_t programId_;
+    std::array<int32_t, static_cast<uint8_t>(Uniform::COUNT)> locations_;
 };
-} // namespace lav::core
\ No newline at end of file
+} // namespace lav::core
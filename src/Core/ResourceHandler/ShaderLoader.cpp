@@ -1,11 +1,48 @@
 #include "ShaderLoader.hpp"
 
-#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <format>
 #include <fstream>
 #include <sstream>
 
+#include "src/Utils/Profiler.hpp"
+
 namespace lav::core
 {
+namespace
+{
+/* Prefixes every cached binary. Bump the version whenever the layout changes. */
+struct BinaryHeader
+{
+    uint32_t magic{0};
+    uint32_t version{0};
+    uint64_t hash{0};
+    uint32_t format{0};
+    uint32_t size{0};
+};
+
+constexpr uint32_t BINARY_MAGIC{0x5056414c}; /* "LAVP" */
+constexpr uint32_t BINARY_VERSION{1};
+
+/* FNV-1a. Only needs to tell sources apart, not to be cryptographically strong. */
+auto hashBytes(const std::string_view data, uint64_t hash = 0xcbf29ce484222325ull) -> uint64_t
+{
+    for (const char c : data)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+const std::vector<ShaderLoader::ProgramPaths> engineProgramPaths
+{
+    {"assets/shaders/batchedElemVert.glsl", "assets/shaders/batchedElemFrag.glsl"},
+    {"assets/shaders/batchedTextVert.glsl", "assets/shaders/batchedTextFrag.glsl"}
+};
+} // namespace
+
 auto ShaderLoader::get() -> ShaderLoader&
 {
     static ShaderLoader instance;
@@ -25,37 +62,135 @@ auto ShaderLoader::load(const fs::path& vertexPath, const fs::path& fragPath) ->
         return programIds_.at(allPathKey);
     }
 
-    uint32_t vertexId{loadPart(GPUBinder::ShaderPartType::VERTEX, vertexPath)};
-    uint32_t fragId{loadPart(GPUBinder::ShaderPartType::FRAG, fragPath)};
+    LAV_PROFILE_ZONE("ShaderLoader::load");
 
-    if (!vertexId || !fragId)
+    const auto startTime = std::chrono::steady_clock::now();
+    const auto sources = readSources(vertexPath, fragPath);
+    if (!sources)
     {
         log_.error("One or more shader parts failed to load!");
         return 0;
     }
 
-    uint32_t programId{core::GPUBinder::get().createProgram()};
-    if (!core::GPUBinder::get().linkPartsToProgram(programId, vertexId, fragId))
+    uint32_t programId{loadBinary(sources->hash)};
+    if (!programId)
     {
-        log_.error("Program '{}' failed to link!", programId);
-        return 0;
+        uint32_t vertexId{GPUBinder::get().loadShaderPartType(GPUBinder::ShaderPartType::VERTEX, sources->vertex)};
+        uint32_t fragId{GPUBinder::get().loadShaderPartType(GPUBinder::ShaderPartType::FRAG, sources->frag)};
+        if (!vertexId || !fragId)
+        {
+            log_.error("One or more shader parts failed to compile!");
+            /* Failed part is already gone, the other one would leak. */
+            if (vertexId) { GPUBinder::get().deleteShaderPart(vertexId); }
+            if (fragId) { GPUBinder::get().deleteShaderPart(fragId); }
+            return 0;
+        }
+
+        programId = core::GPUBinder::get().createProgram();
+        if (!core::GPUBinder::get().linkPartsToProgram(programId, vertexId, fragId))
+        {
+            log_.error("Program '{}' failed to link!", programId);
+            GPUBinder::get().deleteProgram(programId);
+            return 0;
+        }
+
+        ++stats_.binaryMisses;
+        storeBinary(sources->hash, programId);
     }
 
     log_.debug("Loaded shader with programID {}", programId);
     programIds_[allPathKey] = programId;
+    ++stats_.programsLoaded;
+    stats_.loadTimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
 
     return programId;
 }
 
 auto ShaderLoader::checkCacheFirst(const bool value) -> void { checkCache_ = value; }
 
-auto ShaderLoader::loadPart(const GPUBinder::ShaderPartType type, const fs::path& partPath) -> uint32_t
+auto ShaderLoader::warmUp(const std::vector<ProgramPaths>& programs) -> uint32_t
+{
+    LAV_PROFILE_ZONE("ShaderLoader::warmUp");
+
+    struct Pending
+    {
+        std::string key;
+        uint64_t hash{0};
+        uint32_t programId{0};
+    };
+
+    const auto startTime = std::chrono::steady_clock::now();
+    std::vector<Pending> pending;
+    uint32_t usable{0};
+
+    /* First pass submits everything. Cached binaries are ready right away, the rest is left compiling. */
+    for (const auto& [vertexPath, fragPath] : programs)
+    {
+        std::string key = (vertexPath / fragPath).string();
+        if (programIds_.contains(key)) { ++usable; continue; }
+        if (std::ranges::find(pending, key, &Pending::key) != pending.end()) { continue; }
+
+        const auto sources = readSources(vertexPath, fragPath);
+        if (!sources)
+        {
+            log_.error("Couldn't read sources of '{}'!", key);
+            continue;
+        }
+
+        if (const uint32_t programId = loadBinary(sources->hash))
+        {
+            programIds_[key] = programId;
+            ++stats_.programsLoaded;
+            ++usable;
+            continue;
+        }
+
+        const uint32_t programId{GPUBinder::get().createProgram()};
+        GPUBinder::get().linkParts(programId,
+            GPUBinder::get().compileShaderPart(GPUBinder::ShaderPartType::VERTEX, sources->vertex),
+            GPUBinder::get().compileShaderPart(GPUBinder::ShaderPartType::FRAG, sources->frag));
+        pending.emplace_back(std::move(key), sources->hash, programId);
+    }
+
+    /* Second pass only now waits on the driver. */
+    for (auto& p : pending)
+    {
+        if (!GPUBinder::get().isProgramLinked(p.programId))
+        {
+            log_.error("Program '{}' failed to link!", p.key);
+            GPUBinder::get().deleteProgram(p.programId);
+            continue;
+        }
+
+        ++stats_.binaryMisses;
+        storeBinary(p.hash, p.programId);
+        programIds_[p.key] = p.programId;
+        ++stats_.programsLoaded;
+        ++usable;
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    stats_.loadTimeNs += elapsed;
+    log_.debug("Warmed up {}/{} programs in {}us", usable, programs.size(), elapsed / 1000);
+
+    return usable;
+}
+
+auto ShaderLoader::warmUp() -> uint32_t { return warmUp(engineProgramPaths); }
+
+auto ShaderLoader::setBinaryCacheDir(const fs::path& cacheDir) -> void { binaryCacheDir_ = cacheDir; }
+
+auto ShaderLoader::getStats() const -> const Stats& { return stats_; }
+
+auto ShaderLoader::readPart(const fs::path& partPath) -> std::optional<std::string>
 {
     std::ifstream partFile{partPath};
     if (!partFile.is_open())
     {
         log_.error("Could not open shader part for: {}", partPath.string());
-        return 0;
+        return std::nullopt;
     }
     log_.debug("Resolving {}..", partPath.string());
 
@@ -63,6 +198,111 @@ auto ShaderLoader::loadPart(const GPUBinder::ShaderPartType type, const fs::path
     ss << partFile.rdbuf();
     partFile.close();
 
-    return core::GPUBinder::get().loadShaderPartType(type, ss.str());
+    return ss.str();
+}
+
+auto ShaderLoader::readSources(const fs::path& vertexPath, const fs::path& fragPath) -> std::optional<Sources>
+{
+    auto vertex = readPart(vertexPath);
+    auto frag = readPart(fragPath);
+    if (!vertex || !frag) { return std::nullopt; }
+
+    /* A driver update can invalidate binaries, so the driver takes part in the key. */
+    if (driverString_.empty())
+    {
+        driverString_ = GPUBinder::get().getDriverString();
+    }
+
+    Sources sources{std::move(*vertex), std::move(*frag), 0};
+    sources.hash = hashBytes(sources.vertex);
+    sources.hash = hashBytes({"\0", 1}, sources.hash);
+    sources.hash = hashBytes(sources.frag, sources.hash);
+    sources.hash = hashBytes({"\0", 1}, sources.hash);
+    sources.hash = hashBytes(driverString_, sources.hash);
+    return sources;
+}
+
+auto ShaderLoader::loadBinary(const uint64_t hash) -> uint32_t
+{
+    if (binaryCacheDir_.empty() || !GPUBinder::get().isProgramBinarySupported()) { return 0; }
+
+    const fs::path binaryPath = getBinaryPath(hash);
+    std::ifstream file{binaryPath, std::ios::binary};
+    if (!file.is_open()) { return 0; }
+
+    BinaryHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != BINARY_MAGIC || header.version != BINARY_VERSION || header.hash != hash)
+    {
+        log_.warn("Ignoring malformed program binary {}", binaryPath.string());
+        return 0;
+    }
+
+    std::vector<uint8_t> data(header.size);
+    file.read(reinterpret_cast<char*>(data.data()), data.size());
+    if (!file)
+    {
+        log_.warn("Ignoring truncated program binary {}", binaryPath.string());
+        return 0;
+    }
+    file.close();
+
+    const uint32_t programId{GPUBinder::get().createProgram()};
+    if (!GPUBinder::get().loadProgramBinary(programId, header.format, data))
+    {
+        /* Stale for this driver. It gets overwritten once the program is compiled again. */
+        log_.debug("Driver rejected program binary {}", binaryPath.string());
+        GPUBinder::get().deleteProgram(programId);
+        ++stats_.binaryRejects;
+        return 0;
+    }
+
+    ++stats_.binaryHits;
+    return programId;
+}
+
+auto ShaderLoader::storeBinary(const uint64_t hash, const uint32_t programId) -> void
+{
+    if (binaryCacheDir_.empty()) { return; }
+
+    BinaryHeader header{BINARY_MAGIC, BINARY_VERSION, hash, 0, 0};
+    const std::vector<uint8_t> data = GPUBinder::get().getProgramBinary(programId, header.format);
+    if (data.empty()) { return; }
+    header.size = data.size();
+
+    std::error_code ec;
+    fs::create_directories(binaryCacheDir_, ec);
+    if (ec)
+    {
+        log_.warn("Couldn't create program cache dir {}: {}", binaryCacheDir_.string(), ec.message());
+        return;
+    }
+
+    /* Written aside then renamed so another instance never reads a half written file. */
+    const fs::path binaryPath = getBinaryPath(hash);
+    fs::path tempPath = binaryPath;
+    tempPath += ".tmp";
+    {
+        std::ofstream file{tempPath, std::ios::binary | std::ios::trunc};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        if (!file)
+        {
+            log_.warn("Couldn't write program binary {}", tempPath.string());
+            return;
+        }
+    }
+
+    fs::rename(tempPath, binaryPath, ec);
+    if (ec)
+    {
+        log_.warn("Couldn't store program binary {}: {}", binaryPath.string(), ec.message());
+        fs::remove(tempPath, ec);
+    }
+}
+
+auto ShaderLoader::getBinaryPath(const uint64_t hash) const -> fs::path
+{
+    return binaryCacheDir_ / std::format("{:016x}.bin", hash);
 }
-} // namespace lav::core
\ No newline at end of file
+} // namespace lav::core
@@ -1,7 +1,11 @@
 #pragma once
 
 #include <cstdint>
+#include <filesystem>
+#include <optional>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "src/Utils/Logger.hpp"
 #include "src/Core/Binders/GPUBinder.hpp"
@@ -10,15 +14,63 @@ namespace lav::core
 {
 namespace fs = std::filesystem;
 
+/**
+    @brief Loads and caches shader programs.
+
+    @note Linked programs are persisted as driver binaries in an on-disk cache, keyed by a hash of their
+        sources and of the driver string. Next launches load those directly instead of compiling, falling
+        back to compiling whenever the driver rejects a binary or the sources changed.
+*/
 class ShaderLoader
 {
+public:
+    using ProgramPaths = std::pair<fs::path, fs::path>; /* Vertex, fragment */
+
+    struct Stats
+    {
+        uint32_t programsLoaded{0};
+        uint32_t binaryHits{0};     /* Programs created from the on-disk cache */
+        uint32_t binaryMisses{0};   /* Programs that had to be compiled */
+        uint32_t binaryRejects{0};  /* Cached binaries the driver refused */
+        uint64_t loadTimeNs{0};     /* Reading, compiling and linking, cache I/O included */
+    };
+
 public:
     static auto get() -> ShaderLoader&;
 
     auto load(const fs::path& vertexPath, const fs::path& fragPath) -> uint32_t;
     auto checkCacheFirst(const bool value) -> void;
 
+    /**
+        @brief Load many programs in one pass. Every program missing from the binary cache gets compiled
+            and linked before any status is queried so the driver is free to overlap the work.
+
+        @param programs Programs to load
+
+        @return Number of programs that are usable.
+    */
+    auto warmUp(const std::vector<ProgramPaths>& programs) -> uint32_t;
+
+    /** @brief Load every program the engine itself uses. */
+    auto warmUp() -> uint32_t;
+
+    /**
+        @brief Set where program binaries are stored. Binary caching is disabled for an empty path.
+
+        @param cacheDir Directory of the cache. Created on first write
+    */
+    auto setBinaryCacheDir(const fs::path& cacheDir) -> void;
+
+    auto getStats() const -> const Stats&;
+
 private:
+    struct Sources
+    {
+        std::string vertex;
+        std::string frag;
+        uint64_t hash{0};
+    };
+
     ShaderLoader();
     ~ShaderLoader() = default;
     ShaderLoader(const ShaderLoader&) = delete;
@@ -26,11 +78,18 @@ private:
     ShaderLoader& operator=(const ShaderLoader&) = delete;
     ShaderLoader& operator=(ShaderLoader&&) = delete;
 
-    auto loadPart(const core::GPUBinder::ShaderPartType type, const fs::path& partPath) -> uint32_t;
+    auto readPart(const fs::path& partPath) -> std::optional<std::string>;
+    auto readSources(const fs::path& vertexPath, const fs::path& fragPath) -> std::optional<Sources>;
+    auto loadBinary(const uint64_t hash) -> uint32_t;
+    auto storeBinary(const uint64_t hash, const uint32_t programId) -> void;
+    auto getBinaryPath(const uint64_t hash) const -> fs::path;
 
 private:
     utils::Logger log_;
     std::unordered_map<std::string, uint32_t> programIds_;
+    fs::path binaryCacheDir_{".lavcache/shaders"};
+    std::string driverString_;
+    Stats stats_;
     bool checkCache_{true};
 };
-} // namespace lav::core
\ No newline at end of file
+} // namespace lav::core
@@ -0,0 +1,46 @@
+#include "ShelfPacker.hpp"
+
+namespace lav::core
+{
+ShelfPacker::ShelfPacker(const glm::ivec2& size, const int32_t padding)
+    : size_(size)
+    , padding_(padding)
+{}
+
+auto ShelfPacker::pack(const glm::ivec2& size) -> std::optional<glm::ivec2>
+{
+    const glm::ivec2 padded = size + padding_;
+    if (padded.x > size_.x || padded.y > size_.y) { return std::nullopt; }
+
+    /* Best fit: the shortest shelf that can hold it wastes the least height. */
+    Shelf* bestShelf{nullptr};
+    for (auto& shelf : shelves_)
+    {
+        if (shelf.height < padded.y || shelf.usedWidth + padded.x > size_.x) { continue; }
+        if (!bestShelf || shelf.height < bestShelf->height) { bestShelf = &shelf; }
+    }
+
+    /* Only open a new shelf if the existing ones are way too tall, otherwise space is wasted for nothing. */
+    const bool isWasteful = bestShelf && bestShelf->height > padded.y * 2;
+    if ((!bestShelf || isWasteful) && nextShelfY_ + padded.y <= size_.y)
+    {
+        shelves_.emplace_back(Shelf{.y = nextShelfY_, .height = padded.y, .usedWidth = 0});
+        nextShelfY_ += padded.y;
+        bestShelf = &shelves_.back();
+    }
+
+    if (!bestShelf) { return std::nullopt; }
+
+    const glm::ivec2 pos{bestShelf->usedWidth, bestShelf->y};
+    bestShelf->usedWidth += padded.x;
+    return pos;
+}
+
+auto ShelfPacker::reset() -> void
+{
+    shelves_.clear();
+    nextShelfY_ = 0;
+}
+
+auto ShelfPacker::getSize() const -> const glm::ivec2& { return size_; }
+} // namespace lav::core
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "vendor/glm/glm.hpp"
+
+namespace lav::core
+{
+/**
+    @brief Packs rectangles into a fixed size area by stacking them on horizontal shelves.
+
+    @note Good fit for glyphs and icons: heights are similar so very little space is lost, and packing
+        is just a scan over a handful of shelves. Nothing is ever freed, call reset() to start over.
+*/
+class ShelfPacker
+{
+public:
+    /**
+        @param size Size of the area to pack into
+        @param padding Empty space kept around each rectangle so linear filtering doesn't bleed
+    */
+    ShelfPacker(const glm::ivec2& size, const int32_t padding = 1);
+
+    /**
+        @brief Find a place for a rectangle.
+
+        @param size Size of the rectangle to place
+
+        @return Top left corner of the placed rectangle or nullopt if there's no room left.
+    */
+    auto pack(const glm::ivec2& size) -> std::optional<glm::ivec2>;
+    auto reset() -> void;
+    auto getSize() const -> const glm::ivec2&;
+
+private:
+    struct Shelf
+    {
+        int32_t y{0};
+        int32_t height{0};
+        int32_t usedWidth{0};
+    };
+
+private:
+    glm::ivec2 size_;
+    int32_t padding_;
+    int32_t nextShelfY_{0};
+    std::vector<Shelf> shelves_;
+};
+} // namespace lav::core
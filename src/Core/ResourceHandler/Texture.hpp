@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <filesystem>
 #include <memory>
 
 #include "src/Core/Binders/GPUBinder.hpp"
@@ -11,10 +12,13 @@ class Texture
 {
 public:
 enum class Type : uint8_t { UNKNOWN, PNG, JPG, JPEG };
+enum class State : uint8_t { PENDING, RESIDENT, FAILED, EVICTED };
 
 struct Options
 {
     GPUBinder::TextureType texType{GPUBinder::TextureType::Single2D};
+    bool packInAtlas{false}; /* Small images share atlas pages so they can be drawn in one batch */
+    GPUBinder::TextureOptions gpuOptions{}; /* Ignored for atlased images, pages are shared */
 };
 
 public:
@@ -23,6 +27,16 @@ public:
     uint32_t width{0};
     uint8_t numChannels{0};
     Type type{Type::UNKNOWN};
+    State state{State::RESIDENT}; /* Only async loads start as PENDING */
+    glm::vec4 uvRect{0.0f, 0.0f, 1.0f, 1.0f}; /* Normalized region of `id` holding the image */
+    bool isAtlased{false};
+
+    /* Residency bookkeeping. Path and options are what's needed to reload it once evicted. */
+    std::filesystem::path path;
+    Options options;
+    uint64_t gpuBytes{0};      /* Approximate. Zero for atlased images, pages are accounted as a whole */
+    uint64_t lastUsedFrame{0};
+    bool isPinned{false};      /* Loaded synchronously. Copies of `id` live outside the cache, never evicted */
 };
 
 using TexturePtr = std::shared_ptr<Texture>;
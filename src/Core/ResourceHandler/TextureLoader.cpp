@@ -1,10 +1,28 @@
 #include "TextureLoader.hpp"
+
+#include <algorithm>
+#include <optional>
+
 #include "src/Core/Binders/GPUBinder.hpp"
 #include "src/Core/Binders/FileResourceBinder.hpp"
+#include "src/Core/ResourceHandler/BlockDecoder.hpp"
+#include "src/Core/ResourceHandler/LoadingQueue.hpp"
+#include "src/Core/ResourceHandler/ResidencyManager.hpp"
+#include "src/Utils/Profiler.hpp"
 
 
 namespace lav::core
 {
+namespace
+{
+auto estimateBytes(const glm::ivec2& size, const uint32_t bytesPerTexel, const bool hasMipmaps) -> uint64_t
+{
+    /* A full mip chain adds about a third. */
+    const uint64_t base = uint64_t(size.x) * size.y * bytesPerTexel;
+    return hasMipmaps ? base * 4 / 3 : base;
+}
+} // namespace
+
 TextureLoader& TextureLoader::get()
 {
     static TextureLoader instance;
@@ -21,12 +39,126 @@ auto TextureLoader::load(const std::filesystem::path& texPath, const Texture::Op
 {
     if (texPathToObject_.count(texPath))
     {
-        return texPathToObject_.at(texPath);
+        /* Still decoding async or evicted. Load it now into the same object, any async result gets dropped. */
+        const TexturePtr& texture = texPathToObject_.at(texPath);
+        if (texture->state == Texture::State::PENDING || texture->state == Texture::State::EVICTED)
+        {
+            const Texture::Options previousOpts = texture->options;
+            *texture = loadInternal(texPath, opts);
+            texture->path = texPath;
+            texture->options = previousOpts;
+            trackPinned(texture);
+        }
+        return *texture;
     }
 
-    texPathToObject_[texPath] = loadInternal(texPath, opts);
+    const TexturePtr& texture = texPathToObject_[texPath] = std::make_shared<Texture>(loadInternal(texPath, opts));
+    texture->path = texPath;
+    texture->options = opts;
+    trackPinned(texture);
 
-    return texPathToObject_.at(texPath);
+    return *texture;
+}
+
+auto TextureLoader::trackPinned(const TexturePtr& texture) -> void
+{
+    /* Still counted toward the budget, the caller's copy keeps using the id so it can't be evicted. */
+    texture->isPinned = true;
+    if (texture->state != Texture::State::FAILED) { ResidencyManager::get().track(texture); }
+}
+
+auto TextureLoader::loadAsync(const std::filesystem::path& texPath, const Texture::Options& opts,
+    ReadyCallback onReady) -> TexturePtr
+{
+    if (texPathToObject_.count(texPath))
+    {
+        const TexturePtr& texture = texPathToObject_.at(texPath);
+        if (texture->state == Texture::State::EVICTED) { reload(texture, std::move(onReady)); }
+        else if (texture->state == Texture::State::PENDING && onReady)
+        {
+            waitingCallbacks_[texPath].emplace_back(std::move(onReady));
+        }
+        return texture;
+    }
+
+    TexturePtr texture = std::make_shared<Texture>();
+    texture->path = texPath;
+    texture->options = opts;
+    texPathToObject_[texPath] = texture;
+    if (onReady) { waitingCallbacks_[texPath].emplace_back(std::move(onReady)); }
+    queueLoad(texture);
+
+    return texture;
+}
+
+auto TextureLoader::reload(const TexturePtr& texture, ReadyCallback onReady) -> void
+{
+    if (texture->state != Texture::State::EVICTED) { return; }
+
+    if (onReady) { waitingCallbacks_[texture->path].emplace_back(std::move(onReady)); }
+    queueLoad(texture);
+}
+
+auto TextureLoader::queueLoad(const TexturePtr& texture) -> void
+{
+    texture->state = Texture::State::PENDING;
+
+    /* Texture is only touched back on the context thread, workers just decode. */
+    LoadingQueue::get().pushJob([this, texture, texPath = texture->path]()
+    {
+        LAV_PROFILE_ZONE("TextureLoader::decode");
+        const auto info = FileResourceBinder::get().loadTextureData(texPath);
+        LoadingQueue::get().pushUpload([this, texture, texPath, info]()
+        {
+            if (texture->state == Texture::State::PENDING)
+            {
+                Texture loaded;
+                loaded.path = texPath;
+                loaded.options = texture->options;
+                loaded.lastUsedFrame = texture->lastUsedFrame;
+                uploadToGpu(texPath, info, texture->options, loaded);
+                *texture = loaded;
+                if (texture->state == Texture::State::RESIDENT) { ResidencyManager::get().track(texture); }
+            }
+            else if (info.data)
+            {
+                /* A sync load() got there first. */
+                FileResourceBinder::get().freeLoadedTextureData(info);
+            }
+            finishAsync(texPath);
+        });
+    });
+}
+
+auto TextureLoader::unload(const TexturePtr& texture, const bool keepHandle) -> bool
+{
+    /* Atlas pages are shared and their slots can't be given back. Evicting would free nothing and the
+        reload would take a new slot, possibly a whole new page. */
+    if (texture->isAtlased || texture->isPinned) { return false; }
+
+    GPUBinder::get().deleteTexture(texture->id);
+    texture->id = 0;
+    texture->state = Texture::State::EVICTED;
+
+    if (!keepHandle) { texPathToObject_.erase(texture->path); }
+    return true;
+}
+
+auto TextureLoader::getAtlasBytes() const -> uint64_t
+{
+    return atlasPages_.size() * IMAGE_ATLAS_PAGE_SIZE * IMAGE_ATLAS_PAGE_SIZE * 4;
+}
+
+auto TextureLoader::finishAsync(const std::filesystem::path& texPath) -> void
+{
+    const auto it = waitingCallbacks_.find(texPath);
+    if (it == waitingCallbacks_.end()) { return; }
+
+    const auto callbacks = std::move(it->second);
+    waitingCallbacks_.erase(it);
+
+    const TexturePtr& texture = texPathToObject_.at(texPath);
+    for (const auto& callback : callbacks) { callback(texture); }
 }
 
 auto TextureLoader::loadInternal(const std::filesystem::path& texPath, const Texture::Options& opts) -> Texture
@@ -36,39 +168,162 @@ auto TextureLoader::loadInternal(const std::filesystem::path& texPath, const Tex
     /* Load into host memory. */
     core::FileResourceBinder::LoadInfo info =
         core::FileResourceBinder::get().loadTextureData(texPath);
-    if (!info.data)
+    uploadToGpu(texPath, info, opts, texture);
+
+    return texture;
+}
+
+auto TextureLoader::uploadToGpu(const std::filesystem::path& texPath, const FileResourceBinder::LoadInfo& info,
+    const Texture::Options& opts, Texture& texture) -> void
+{
+    LAV_PROFILE_ZONE("TextureLoader::uploadToGpu");
+
+    if (!info.isValid())
     {
         log_.error("Load from path failed for '{}'", texPath.string());
-        return texture;
+        texture.state = Texture::State::FAILED;
+        return;
     }
 
-    const auto colorType =
-        info.fileExt == FileResourceBinder::FileExt::PNG
-        ? GPUBinder::ColorType::RGBA : GPUBinder::ColorType::RGB;
+    const bool isSmall = info.width <= IMAGE_ATLAS_MAX_SIZE && info.height <= IMAGE_ATLAS_MAX_SIZE;
+    if (opts.packInAtlas && isSmall && info.data && packIntoAtlas(info, texture))
+    {
+        core::FileResourceBinder::get().freeLoadedTextureData(info);
+        texture.state = Texture::State::RESIDENT;
+        log_.debug("Packed '{}' into atlas textureId '{}'", texPath.string(), texture.id);
+        return;
+    }
 
     texture.width = info.width;
     texture.height = info.height;
     texture.numChannels = info.numChannels;
+    if (info.compressedFormat)
+    {
+        texture.id = createCompressed(texPath, info, opts, texture);
+        return finishUpload(texPath, texture);
+    }
+
+    const auto colorType =
+        info.fileExt == FileResourceBinder::FileExt::PNG
+        ? GPUBinder::ColorType::RGBA : GPUBinder::ColorType::RGB;
+
     texture.id = GPUBinder::get().createTexture(
         texture.width,
         texture.height,
         0, /* No slices. One texture. */
         GPUBinder::TextureType::Single2D,
         colorType,
-        GPUBinder::TextureOptions{},
+        opts.gpuOptions,
         info.data);
-    
+
+    /* Drivers pad RGB8 to 4 bytes per texel. */
+    texture.gpuBytes = estimateBytes({info.width, info.height}, 4, opts.gpuOptions.generateMipmaps);
+
+    /* Free host data */
+    core::FileResourceBinder::get().freeLoadedTextureData(info);
+
+    finishUpload(texPath, texture);
+}
+
+auto TextureLoader::createCompressed(const std::filesystem::path& texPath, const FileResourceBinder::LoadInfo& info,
+    const Texture::Options& opts, Texture& texture) -> uint32_t
+{
+    auto& gpuBinder = GPUBinder::get();
+    const auto format = info.compressedFormat.value();
+    const glm::ivec2 size{info.width, info.height};
+    if (gpuBinder.isCompressedFormatSupported(format))
+    {
+        texture.gpuBytes = 0;
+        for (const auto& level : info.levels) { texture.gpuBytes += level.size(); }
+        return gpuBinder.createCompressedTexture(size, format, info.levels, opts.gpuOptions);
+    }
+
+    /* Driver can't sample it. Decode the base level and let mipmaps be generated if wanted. */
+    auto pixels = decodeBlocksToRgba(format, size, info.levels.front());
+    if (!pixels)
+    {
+        log_.error("Compressed format of '{}' is not supported by the driver nor decodable", texPath.string());
+        return 0;
+    }
+
+    log_.warn("Compressed format of '{}' is not supported by the driver, decoded on the CPU", texPath.string());
+    texture.gpuBytes = estimateBytes(size, 4, opts.gpuOptions.generateMipmaps);
+    return gpuBinder.createTexture(size.x, size.y, 0, GPUBinder::TextureType::Single2D,
+        GPUBinder::ColorType::RGBA, opts.gpuOptions, pixels->data());
+}
+
+auto TextureLoader::finishUpload(const std::filesystem::path& texPath, Texture& texture) -> void
+{
     if (!texture.id)
     {
         log_.error("Could not create GPU texture for '{}'", texPath.string());
-        return texture;
+        texture.state = Texture::State::FAILED;
+        return;
     }
 
-    /* Free host data */
-    core::FileResourceBinder::get().freeLoadedTextureData(info);
-
+    texture.state = Texture::State::RESIDENT;
     log_.debug("Created textureId '{}' for GPU from '{}'", texture.id, texPath.string());
+}
+auto TextureLoader::packIntoAtlas(const FileResourceBinder::LoadInfo& info, Texture& texture) -> bool
+{
+    /* Pages are RGBA. Only 3 and 4 channel images are expected from the decoder. */
+    if (info.numChannels != 3 && info.numChannels != 4) { return false; }
 
-    return texture;
+    const glm::ivec2 size{info.width, info.height};
+    AtlasPage* page{nullptr};
+    std::optional<glm::ivec2> pos;
+    for (auto& p : atlasPages_)
+    {
+        if ((pos = p.packer.pack(size))) { page = &p; break; }
+    }
+
+    if (!page)
+    {
+        auto& gpuBinder = GPUBinder::get();
+        const uint32_t pageId = gpuBinder.createTexture(IMAGE_ATLAS_PAGE_SIZE, IMAGE_ATLAS_PAGE_SIZE, 0,
+            GPUBinder::TextureType::Single2D, GPUBinder::ColorType::RGBA, GPUBinder::TextureOptions{}, nullptr);
+        if (!pageId)
+        {
+            log_.error("Could not create image atlas page");
+            return false;
+        }
+
+        page = &atlasPages_.emplace_back(AtlasPage{.textureId = pageId});
+        pos = page->packer.pack(size);
+        log_.debug("Image atlas now has {} pages", atlasPages_.size());
+    }
+    if (!pos) { return false; }
+
+    /* Expand to RGBA so everything can live in the same page. */
+    std::vector<uint8_t> rgbaStorage;
+    const unsigned char* pixels = info.data;
+    if (info.numChannels == 3)
+    {
+        rgbaStorage.resize(info.width * info.height * 4);
+        for (int32_t i = 0; i < info.width * info.height; ++i)
+        {
+            std::copy_n(info.data + i * 3, 3, rgbaStorage.begin() + i * 4);
+            rgbaStorage[i * 4 + 3] = 255;
+        }
+        pixels = rgbaStorage.data();
+    }
+
+    auto& gpuBinder = GPUBinder::get();
+    gpuBinder.bindIdToTextureType(GPUBinder::TextureType::Single2D, page->textureId);
+    gpuBinder.bufferTextureRegion({pos.value(), size}, 0, GPUBinder::TextureType::Single2D,
+        GPUBinder::ColorType::RGBA, pixels);
+    gpuBinder.bindIdToTextureType(GPUBinder::TextureType::Single2D, 0);
+
+    /* Half a texel inwards so linear filtering never samples the neighbours. */
+    const glm::vec2 texel{0.5f / IMAGE_ATLAS_PAGE_SIZE};
+    texture.id = page->textureId;
+    texture.width = info.width;
+    texture.height = info.height;
+    texture.numChannels = 4;
+    texture.uvRect = glm::vec4{glm::vec2{pos.value()} / (float)IMAGE_ATLAS_PAGE_SIZE + texel,
+        glm::vec2{size} / (float)IMAGE_ATLAS_PAGE_SIZE - 2.0f * texel};
+    texture.isAtlased = true;
+
+    return true;
 }
-} // namespace lav::core
\ No newline at end of file
+} // namespace lav::core
@@ -1,21 +1,90 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "src/Utils/Logger.hpp"
+#include "src/Core/Binders/FileResourceBinder.hpp"
+#include "src/Core/ResourceHandler/ShelfPacker.hpp"
 #include "src/Core/ResourceHandler/Texture.hpp"
 #include "vendor/glm/glm.hpp"
 
 namespace lav::core
 {
+static constexpr int32_t IMAGE_ATLAS_PAGE_SIZE  {2048};
+static constexpr int32_t IMAGE_ATLAS_MAX_SIZE   {256};
+
+/**
+    @brief Loads image files into GPU textures.
+
+    @note KTX2 files holding BC1/3/7 or ETC2 blocks are uploaded as is. BC1/3 fall back to CPU decoding
+        when the driver can't sample them.
+    @note With Texture::Options::packInAtlas, images up to IMAGE_ATLAS_MAX_SIZE on each side are packed into
+        shared RGBA atlas pages instead of getting a texture each. The Texture then points at the page and
+        carries the image's uvRect. Bigger images always get their own texture.
+*/
 class TextureLoader
 {
+public:
+    using ReadyCallback = std::function<void(const TexturePtr&)>;
+
 public:
     static TextureLoader& get();
 
+    /**
+        @brief Load a texture right away, blocking until it's on the GPU.
+
+        @note Counted toward the ResidencyManager budget but never evicted, the returned copy keeps using
+            the id. Same goes for an async texture this loads early.
+
+        @param texPath Path to the image
+        @param opts Texture options
+
+        @return Loaded texture. Check its state for failures.
+    */
     auto load(const std::filesystem::path& texPath, const Texture::Options& opts) -> Texture;
 
+    /**
+        @brief Load a texture without blocking. Decoding happens on the LoadingQueue workers and the GPU
+            upload on the context thread once uploads get drained.
+
+        @note Loading an already requested path returns the same texture, pending or not.
+
+        @param texPath Path to the image
+        @param opts Texture options
+        @param onReady Called on the context thread once the texture is resident or failed to load. Not
+            called if the texture is already resident or failed
+
+        @return Texture that stays PENDING with a zero id until it's resident.
+    */
+    auto loadAsync(const std::filesystem::path& texPath, const Texture::Options& opts,
+        ReadyCallback onReady = {}) -> TexturePtr;
+
+    /**
+        @brief Load an evicted texture again, asynchronously, into the same object.
+
+        @param texture Evicted texture
+        @param onReady Called on the context thread once the texture is resident or failed to load
+    */
+    auto reload(const TexturePtr& texture, ReadyCallback onReady = {}) -> void;
+
+    /**
+        @brief Free the GPU storage of a texture. Used by the ResidencyManager.
+
+        @param texture Texture to unload
+        @param keepHandle If true the texture becomes EVICTED and can be reloaded, otherwise it's also
+            forgotten by the cache
+
+        @return False if the texture lives in an image atlas page or was loaded synchronously. Those are never
+            unloaded.
+    */
+    auto unload(const TexturePtr& texture, const bool keepHandle) -> bool;
+
+    /** @brief GPU bytes of all image atlas pages. */
+    auto getAtlasBytes() const -> uint64_t;
+
 private:
     TextureLoader();
     ~TextureLoader();
@@ -26,10 +95,27 @@ private:
     TextureLoader& operator=(TextureLoader&&) = delete;
 
     auto loadInternal(const std::filesystem::path& texPath, const Texture::Options& opts) -> Texture;
+    auto uploadToGpu(const std::filesystem::path& texPath, const FileResourceBinder::LoadInfo& info,
+        const Texture::Options& opts, Texture& texture) -> void;
+    auto packIntoAtlas(const FileResourceBinder::LoadInfo& info, Texture& texture) -> bool;
+    auto createCompressed(const std::filesystem::path& texPath, const FileResourceBinder::LoadInfo& info,
+        const Texture::Options& opts, Texture& texture) -> uint32_t;
+    auto finishUpload(const std::filesystem::path& texPath, Texture& texture) -> void;
+    auto finishAsync(const std::filesystem::path& texPath) -> void;
+    auto queueLoad(const TexturePtr& texture) -> void;
+    auto trackPinned(const TexturePtr& texture) -> void;
 
 private:
     utils::Logger log_{"TextureLoader"};
 
-    std::unordered_map<std::filesystem::path, Texture> texPathToObject_;
+    std::unordered_map<std::filesystem::path, TexturePtr> texPathToObject_;
+    std::unordered_map<std::filesystem::path, std::vector<ReadyCallback>> waitingCallbacks_;
+
+    struct AtlasPage
+    {
+        uint32_t textureId{0};
+        ShelfPacker packer{{IMAGE_ATLAS_PAGE_SIZE, IMAGE_ATLAS_PAGE_SIZE}};
+    };
+    std::vector<AtlasPage> atlasPages_;
 };
 } // namespace lav::core
\ No newline at end of file
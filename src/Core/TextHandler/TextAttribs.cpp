@@ -1,77 +1,120 @@
 #include "TextAttribs.hpp"
+
+#include <algorithm>
+
 #include "src/Core/ResourceHandler/Font.hpp"
 #include "src/Core/ResourceHandler/FontLoader.hpp"
-#include "vendor/glm/gtc/matrix_transform.hpp"
 
 namespace lav::core
 {
 TextAttribs::TextAttribs()
-    : shader_(ShaderLoader::get().load(
-        "assets/shaders/basicTextVert.glsl", "assets/shaders/basicTextFrag.glsl"))
-    , font_(FontLoader::get().loadFont(core::DEFAULT_FONT_PATH))
-    
-{}
-
-auto TextAttribs::computeMaxSize() const -> glm::vec2
+    : font_(FontLoader::get().loadFont(core::DEFAULT_FONT_PATH))
 {
-    glm::vec2 size{0, 0};
-    for (const uint8_t ch : text_)
-    {
-        const auto& cp = font_->glyphData[ch];
-        size.x += cp.hAdvance >> 6;
-        size.y = std::max(size.y, (float)cp.bearing.y);
-    }
-    return size;
+    reshape();
 }
 
+auto TextAttribs::computeMaxSize() const -> glm::vec2 { return shaped_->size; }
+
 auto TextAttribs::setFont(const std::filesystem::path& fontPath) -> void
 {
     // fontPath_ = fontPath;
 }
 
+auto TextAttribs::setFont(const FontPtr& font) -> void
+{
+    if (!font || font == font_) { return; }
+
+    font_ = font;
+    reshape();
+}
+
 auto TextAttribs::setText(std::string text) -> void
 {
+    if (text == text_) { return; }
+
     text_ = std::move(text);
+    reshape();
+}
 
-    buffer_ = std::move(TextSoA(text.size()));
-    glm::ivec2 startPos{pos_};
-    float z{0.1f};
-    // float mockIndex = 10;
-    // this supports only one line for now
-    // obviously this needs to be done only if the text changes
-    const glm::ivec2 textBounds = computeMaxSize();
-    for (const uint8_t c : text_)
-    {
-        const auto& glyphData = font_->glyphData[c];
-        const float x = startPos.x + glyphData.bearing.x;
-        const float y = startPos.y - glyphData.bearing.y + textBounds.y;
+auto TextAttribs::setPosition(const glm::ivec3& pos) -> void
+{
+    /* Layout runs often, most of the time nothing moved. */
+    if (glm::vec3{pos} == pos_) { return; }
+
+    pos_ = pos;
+    updateVisibleLines();
+    bumpVersion();
+}
 
-        glm::mat4 modelMatrix = glm::mat4(1.0f);
-        modelMatrix = glm::translate(modelMatrix, glm::vec3{x, y, pos_.z + z});
-        modelMatrix = glm::scale(modelMatrix, glm::vec3{font_->fontSize, font_->fontSize, 1});
+auto TextAttribs::setLayout(const TextLayout& layout) -> void
+{
+    if (layout == layout_) { return; }
+
+    layout_ = layout;
+    reshape();
+}
+
+auto TextAttribs::setValidBounds(const glm::vec2& start, const glm::vec2& scale) -> void
+{
+    const glm::vec4 bounds{start, scale};
+    if (validBounds_ == bounds) { return; }
+
+    validBounds_ = bounds;
+
+    /* Only what's emitted matters to the renderer. */
+    const glm::uvec2 previous = visibleLines_;
+    updateVisibleLines();
+    if (previous != visibleLines_) { bumpVersion(); }
+}
 
-        startPos.x += (glyphData.hAdvance >> 6);
-        z += 0.01f;
+auto TextAttribs::reshape() -> void
+{
+    shaped_ = TextShaper::get().shape(font_, text_, layout_);
+    updateVisibleLines();
+    bumpVersion();
+}
 
-        buffer_.glyphCode.emplace_back(glyphData.glyphCode);
-        buffer_.model.emplace_back(std::move(modelMatrix));
+auto TextAttribs::updateVisibleLines() -> void
+{
+    const auto& lines = shaped_->lines;
+    if (!validBounds_)
+    {
+        visibleLines_ = {0, lines.size()};
+        return;
     }
+
+    /* Lines are ordered top to bottom, so the visible ones are a contiguous range. */
+    const float top = validBounds_->y - pos_.y;
+    const float bottom = top + validBounds_->w;
+    const auto first = std::ranges::partition_point(lines,
+        [top](const ShapedText::Line& line) { return line.bottom <= top; });
+    const auto last = std::ranges::partition_point(first, lines.end(),
+        [bottom](const ShapedText::Line& line) { return line.top < bottom; });
+
+    visibleLines_ = {first - lines.begin(), last - lines.begin()};
 }
 
-auto TextAttribs::setPosition(const glm::ivec3& pos) -> void
+auto TextAttribs::bumpVersion() -> void
 {
-    pos_ = pos;
-    // only if the position really changes..
-    setText(text_);
+    /* Shared by all text objects so a version is never reused, not even by a different object. */
+    static uint64_t lastVersion{0};
+    version_ = ++lastVersion;
 }
 
-auto TextAttribs::setValidBounds(const glm::vec2& start, const glm::vec2& scale) -> void
+auto TextAttribs::getGlyphs() const -> std::span<const Glyph>
 {
+    if (visibleLines_.x >= visibleLines_.y) { return {}; }
 
+    const auto& lines = shaped_->lines;
+    const uint32_t start = lines[visibleLines_.x].glyphStart;
+    const uint32_t end = lines[visibleLines_.y - 1].glyphStart + lines[visibleLines_.y - 1].glyphCount;
+    return std::span<const Glyph>{shaped_->glyphs}.subspan(start, end - start);
 }
 
-auto TextAttribs::getText() const -> std::string { return text_; }
-auto TextAttribs::getBuffer() const -> const TextSoA& { return buffer_; }
+auto TextAttribs::getText() const -> const std::string& { return text_; }
+auto TextAttribs::getPosition() const -> const glm::vec3& { return pos_; }
+auto TextAttribs::getLayout() const -> const TextLayout& { return layout_; }
 auto TextAttribs::getFont() const -> const FontPtr& { return font_; }
-auto TextAttribs::getShader() -> Shader& { return shader_; }
-} // namespace lav::core
\ No newline at end of file
+auto TextAttribs::getLineCount() const -> uint32_t { return shaped_->lines.size(); }
+auto TextAttribs::getVersion() const -> uint64_t { return version_; }
+} // namespace lav::core
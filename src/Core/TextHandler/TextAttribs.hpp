@@ -2,53 +2,85 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
 #include "src/Core/ResourceHandler/Font.hpp"
-#include "src/Core/ResourceHandler/Shader.hpp"
-#include "src/Core/ResourceHandler/ShaderLoader.hpp"
+#include "src/Core/TextHandler/TextShaper.hpp"
 #include "vendor/glm/glm.hpp"
 
 namespace lav::core
 {
+/**
+    @brief Text placed somewhere in a window.
+
+    @note Shaping is cached (see TextShaper) and only redone when the text, font or layout changes. Moving
+        the text around only changes the offset applied to the shaped glyphs.
+    @note Lines falling outside the valid bounds are culled as a whole and never reach the renderer.
+*/
 class TextAttribs
 {
-struct TextSoA;
+public:
+    using Glyph = ShapedText::Glyph;
 
 public:
     TextAttribs();
     auto computeMaxSize() const -> glm::vec2;
 
     auto setFont(const std::filesystem::path& fontPath) -> void;
+    auto setFont(const FontPtr& font) -> void;
     auto setText(std::string text) -> void;
     auto setPosition(const glm::ivec3& pos) -> void;
+    auto setLayout(const TextLayout& layout) -> void;
+
+    /**
+        @brief Set the area in which the text is visible. Lines fully outside of it are not emitted.
+
+        @param start Top left corner of the area, in window coordinates
+        @param scale Size of the area
+    */
     auto setValidBounds(const glm::vec2& start, const glm::vec2& scale) -> void;
 
-    auto getShader() -> Shader&;
-    auto getText() const -> std::string;
-    auto getBuffer() const -> const TextSoA&;
+    auto getText() const -> const std::string&;
+    auto getPosition() const -> const glm::vec3&;
+    auto getLayout() const -> const TextLayout&;
     auto getFont() const -> const FontPtr&;
+    auto getLineCount() const -> uint32_t;
+
+    /**
+        @brief Get the shaped glyphs of the visible lines.
+
+        @note Positions are relative to the text's origin. Offset them by getPosition() to place them.
+
+        @return Glyphs with something to draw. Whitespace is skipped.
+    */
+    auto getGlyphs() const -> std::span<const Glyph>;
+
+    /**
+        @brief Get the version of the placed glyphs.
+
+        @note Changes each time the text or its position changes and is unique across all text objects, so
+            renderers can tell if what they uploaded last time is still valid.
+
+        @return Current version.
+    */
+    auto getVersion() const -> uint64_t;
 
 private:
-    struct TextSoA
-    {
-        TextSoA() {}
-        TextSoA(const uint32_t size)
-        {
-            glyphCode.reserve(size);
-            model.reserve(size);
-        }
-
-        std::vector<int32_t> glyphCode;
-        std::vector<glm::mat4> model;
-    };
+    auto bumpVersion() -> void;
+    auto reshape() -> void;
+    auto updateVisibleLines() -> void;
 
 private:
-    Shader shader_;
-    TextSoA buffer_;
+    ShapedTextPtr shaped_;
+    TextLayout layout_;
+    std::optional<glm::vec4> validBounds_;
+    glm::uvec2 visibleLines_{0}; /* First line, one past the last line */
     glm::vec3 pos_{0.0f};
     std::string text_;
     FontPtr font_;
+    uint64_t version_{0};
 };
 } // namespace lav::core
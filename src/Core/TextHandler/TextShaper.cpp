@@ -0,0 +1,197 @@
+#include "TextShaper.hpp"
+
+#include <algorithm>
+
+#include "src/Core/ResourceHandler/FontLoader.hpp"
+#include "src/Utils/Misc.hpp"
+
+namespace lav::core
+{
+auto TextShaper::get() -> TextShaper&
+{
+    static TextShaper instance;
+    return instance;
+}
+
+auto TextShaper::shape(const FontPtr& font, const std::string& text, const TextLayout& layout) -> ShapedTextPtr
+{
+    Key key{.font = font.get(), .text = text, .layout = layout};
+    if (const auto it = cache_.find(key); it != cache_.end())
+    {
+        if (auto shaped = it->second.lock())
+        {
+            ++stats_.hits;
+            return shaped;
+        }
+    }
+
+    ++stats_.misses;
+    auto shaped = shapeInternal(font, text, layout);
+    cache_.insert_or_assign(std::move(key), shaped);
+
+    /* Results nobody uses anymore only leave an expired entry behind. Sweep them once in a while. */
+    if (cache_.size() >= pruneAt_) { pruneExpired(); }
+
+    return shaped;
+}
+
+auto TextShaper::getStats() const -> const Stats& { return stats_; }
+
+auto TextShaper::shapeInternal(const FontPtr& font, const std::string& text,
+    const TextLayout& layout) -> ShapedTextPtr
+{
+    auto& fontLoader = FontLoader::get();
+    auto shaped = std::make_shared<ShapedText>();
+    shaped->font = font;
+
+    /* Glyph references are stable, the font's glyph map never moves its nodes. */
+    /* Metrics of shared SDF atlases are at the base size and need scaling to the requested one. */
+    const float scale = font->scale;
+    decoded_.clear();
+    advances_.clear();
+    for (std::size_t pos = 0; pos < text.size();)
+    {
+        decoded_.emplace_back(&fontLoader.getGlyph(*font, utils::nextCodepoint(text, pos)));
+        advances_.emplace_back((decoded_.back()->hAdvance >> 6) * scale);
+    }
+
+    const Font::GlyphData& dot = fontLoader.getGlyph(*font, '.');
+    const float dotAdvance = (dot.hAdvance >> 6) * scale;
+    breakLines(layout, layout.ellipsis ? 3 * dotAdvance : 0.0f);
+    const float lineAdvance = font->lineHeight * layout.lineSpacing;
+    const auto placeGlyph = [&shaped, scale](const Font::GlyphData& glyphData, const float penX,
+        const float baseline)
+    {
+        /* Nothing to draw for whitespace. */
+        if (glyphData.size.x == 0 || glyphData.size.y == 0) { return; }
+
+        /* Quad covers just the glyph bitmap, not the whole em box. */
+        const glm::vec2 bearing = glm::vec2{glyphData.bearing} * scale;
+        shaped->glyphs.emplace_back(ShapedText::Glyph{
+            .rect = {penX + bearing.x, baseline - bearing.y, glm::vec2{glyphData.size} * scale},
+            .uvRect = glyphData.uvRect,
+            .page = glyphData.page});
+    };
+
+    shaped->lines.reserve(runs_.size());
+    for (uint32_t i = 0; i < runs_.size(); ++i)
+    {
+        const Run& run = runs_[i];
+        const float top = i * lineAdvance;
+        const float baseline = top + font->ascender;
+
+        ShapedText::Line line{
+            .glyphStart = static_cast<uint32_t>(shaped->glyphs.size()),
+            .top = top,
+            .bottom = top + font->ascender - font->descender,
+            .width = run.width};
+
+        float penX{0.0f};
+        for (uint32_t c = run.start; c < run.end; ++c)
+        {
+            placeGlyph(*decoded_[c], penX, baseline);
+            penX += advances_[c];
+        }
+
+        if (run.isTruncated && layout.ellipsis)
+        {
+            for (int32_t d = 0; d < 3; ++d)
+            {
+                placeGlyph(dot, penX, baseline);
+                penX += dotAdvance;
+            }
+            line.width = penX;
+        }
+
+        line.glyphCount = shaped->glyphs.size() - line.glyphStart;
+        shaped->size.x = std::max(shaped->size.x, line.width);
+        shaped->size.y = line.bottom;
+        shaped->lines.emplace_back(line);
+    }
+
+    return shaped;
+}
+
+auto TextShaper::breakLines(const TextLayout& layout, const float ellipsisWidth) -> void
+{
+    runs_.clear();
+
+    const bool isBounded = layout.maxWidth > 0.0f;
+    const bool canWrap = isBounded && layout.wrap != TextLayout::Wrap::NONE;
+    const auto advanceOf = [this](const uint32_t i) -> float { return advances_[i]; };
+    const auto isSpace = [this](const uint32_t i) { return decoded_[i]->codepoint == ' '; };
+
+    Run run;
+    std::optional<uint32_t> lastSpace;
+    for (uint32_t i = 0; i < decoded_.size(); ++i)
+    {
+        if (decoded_[i]->codepoint == '\n')
+        {
+            run.end = i;
+            runs_.emplace_back(run);
+            run = Run{.start = i + 1, .end = i + 1};
+            lastSpace.reset();
+            continue;
+        }
+
+        const float advance = advanceOf(i);
+        if (canWrap && run.width + advance > layout.maxWidth && i > run.start && !isSpace(i))
+        {
+            /* Break after the last space if there is one, the space itself is dropped. */
+            const bool byWord = layout.wrap == TextLayout::Wrap::WORD && lastSpace && *lastSpace > run.start;
+            const uint32_t breakAt = byWord ? *lastSpace : i;
+            const uint32_t nextStart = byWord ? *lastSpace + 1 : i;
+
+            run.end = breakAt;
+            run.width = 0.0f;
+            for (uint32_t c = run.start; c < run.end; ++c) { run.width += advanceOf(c); }
+            runs_.emplace_back(run);
+
+            run = Run{.start = nextStart, .end = nextStart};
+            for (uint32_t c = run.start; c < i; ++c) { run.width += advanceOf(c); }
+            lastSpace.reset();
+        }
+
+        if (isSpace(i)) { lastSpace = i; }
+        run.width += advance;
+    }
+    run.end = decoded_.size();
+    runs_.emplace_back(run);
+
+    /* Trailing spaces don't count towards the line width. */
+    for (auto& r : runs_)
+    {
+        while (r.end > r.start && isSpace(r.end - 1) && canWrap)
+        {
+            r.width -= advanceOf(--r.end);
+        }
+    }
+
+    if (layout.maxLines && runs_.size() > layout.maxLines)
+    {
+        runs_.resize(layout.maxLines);
+        runs_.back().isTruncated = true;
+    }
+
+    for (auto& r : runs_)
+    {
+        if (isBounded && r.width > layout.maxWidth) { r.isTruncated = true; }
+        if (r.isTruncated && isBounded) { truncateRun(r, layout.maxWidth - ellipsisWidth); }
+    }
+}
+
+auto TextShaper::truncateRun(Run& run, const float maxWidth) -> void
+{
+    /* Drop glyphs from the end until the line fits. */
+    while (run.end > run.start && run.width > maxWidth)
+    {
+        run.width -= advances_[--run.end];
+    }
+}
+
+auto TextShaper::pruneExpired() -> void
+{
+    std::erase_if(cache_, [](const auto& entry) { return entry.second.expired(); });
+    pruneAt_ = std::max<std::size_t>(64, cache_.size() * 2);
+}
+} // namespace lav::core
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "src/Core/ResourceHandler/Font.hpp"
+#include "vendor/glm/glm.hpp"
+
+namespace lav::core
+{
+/** @brief How text is broken into lines and what happens when it doesn't fit. */
+struct TextLayout
+{
+    enum class Wrap
+    {
+        NONE, /* Only explicit new lines */
+        WORD, /* Break between words. Words longer than a line are broken anywhere */
+        CHAR  /* Break anywhere */
+    };
+
+    Wrap wrap{Wrap::NONE};
+    float maxWidth{0.0f};    /* Width lines are wrapped or truncated at. Zero means unbounded */
+    uint32_t maxLines{0};    /* Lines past this are dropped. Zero means unbounded */
+    float lineSpacing{1.0f}; /* Multiplier of the font's line height */
+    bool ellipsis{false};    /* Mark truncated lines with "..." */
+
+    auto operator==(const TextLayout&) const -> bool = default;
+};
+
+/**
+    @brief Result of shaping a string with a font. Glyphs are placed relative to the text's origin so the
+        same result can be reused at any position.
+*/
+struct ShapedText
+{
+    struct Glyph
+    {
+        glm::vec4 rect{0.0f};   /* x, y, w, h relative to the text origin */
+        glm::vec4 uvRect{0.0f}; /* Normalized x, y, w, h inside the atlas page */
+        uint32_t page{0};
+    };
+
+    struct Line
+    {
+        uint32_t glyphStart{0};
+        uint32_t glyphCount{0};
+        float top{0.0f};    /* Top of the line box relative to the text origin */
+        float bottom{0.0f}; /* Bottom of the line box relative to the text origin */
+        float width{0.0f};
+    };
+
+    std::vector<Glyph> glyphs; /* Ordered by line */
+    std::vector<Line> lines;   /* Ordered top to bottom */
+    glm::vec2 size{0.0f};
+    FontPtr font; /* Keeps the font (and the cache key) alive for as long as the result is used */
+};
+using ShapedTextPtr = std::shared_ptr<const ShapedText>;
+
+/**
+    @brief Cache of shaped text shared by all text objects, keyed by (font, string).
+
+    @note Entries are weakly held: a result lives for as long as some text object uses it. Labels showing
+        the same string with the same font share one result.
+*/
+class TextShaper
+{
+public:
+    struct Stats
+    {
+        uint64_t hits{0};
+        uint64_t misses{0};
+    };
+
+public:
+    static auto get() -> TextShaper&;
+
+    /**
+        @brief Get the shaped result of a string, shaping it only if no one else is using it already.
+
+        @param font Font to shape with
+        @param text UTF-8 text to shape
+        @param layout How to break and truncate lines
+
+        @return Shared, immutable shaping result.
+    */
+    auto shape(const FontPtr& font, const std::string& text, const TextLayout& layout = {}) -> ShapedTextPtr;
+
+    auto getStats() const -> const Stats&;
+
+private:
+    TextShaper() = default;
+    ~TextShaper() = default;
+
+    struct Run
+    {
+        uint32_t start{0};
+        uint32_t end{0};
+        float width{0.0f};
+        bool isTruncated{false};
+    };
+
+    auto shapeInternal(const FontPtr& font, const std::string& text, const TextLayout& layout) -> ShapedTextPtr;
+    auto breakLines(const TextLayout& layout, const float ellipsisWidth) -> void;
+    auto truncateRun(Run& run, const float maxWidth) -> void;
+    auto pruneExpired() -> void;
+
+    /* Cannot be copied or moved */
+    TextShaper(const TextShaper&) = delete;
+    TextShaper(TextShaper&&) = delete;
+    TextShaper& operator=(const TextShaper&) = delete;
+    TextShaper& operator=(TextShaper&&) = delete;
+
+private:
+    struct Key
+    {
+        const Font* font{nullptr};
+        std::string text;
+        TextLayout layout;
+
+        auto operator==(const Key&) const -> bool = default;
+    };
+
+    struct KeyHash
+    {
+        auto operator()(const Key& key) const -> std::size_t
+        {
+            return std::hash<std::string>{}(key.text) ^ (std::hash<const Font*>{}(key.font) << 1);
+        }
+    };
+
+    std::unordered_map<Key, std::weak_ptr<const ShapedText>, KeyHash> cache_;
+    std::size_t pruneAt_{64};
+
+    /* Scratch space reused between shapes. */
+    std::vector<const Font::GlyphData*> decoded_;
+    std::vector<float> advances_;
+    std::vector<Run> runs_;
+
+    Stats stats_;
+};
+} // namespace lav::core
@@ -9,7 +9,7 @@ namespace lav::node
 class UIScroll : public UISlider
 {
 public:
-    INSERT_CONSTRUCT_COPY_MOVE_DEFS(UIScroll, "elemVert.glsl", "elemFrag.glsl");
+    INSERT_CONSTRUCT_COPY_MOVE_DEFS(UIScroll);
     INSERT_ADD_REMOVE_NOT_ALLOWED(UIScroll);
 
 private:
@@ -3,20 +3,16 @@
 #include <algorithm>
 #include <cxxabi.h>
 
-#include "src/Core/ResourceHandler/ShaderLoader.hpp"
-#include "src/Core/ResourceHandler/MeshLoader.hpp"
 #include "src/Utils/Misc.hpp"
 
 namespace lav::node
 {
+uint64_t UIBase::topologyVersion_ = 0;
+
 UIBase::UIBase(UIBaseInitData&& initData)
     : nameTag_(initData.name)
     , id_(utils::genId())
     , log_("{}/{}", initData.name, id_)
-    , mesh_(core::MeshLoader::get().loadQuad())
-    , shader_(core::ShaderLoader::get().load(
-        "assets/shaders" / initData.vertexShader,
-        "assets/shaders" / initData.fragmentShader))
     , baseColor_{utils::hexToVec4("#ffffffff")}
     , borderColor_{utils::hexToVec4("#979797ff")}
     , depth_(0)
@@ -24,6 +20,18 @@ UIBase::UIBase(UIBaseInitData&& initData)
     , isIgnoringEvents_(false)
 {}
 
+UIBase::~UIBase()
+{
+    /* Children can outlive us if someone else still holds them. They must not point to our layout anymore. */
+    for (const auto& element : elements_)
+    {
+        if (!element) { continue; }
+
+        element->isParented_ = false;
+        element->layoutBase_.setParentLayout(nullptr);
+    }
+}
+
 auto UIBase::add(const UIBasePtr& element) -> bool
 {
     if (!element)
@@ -46,7 +54,10 @@ auto UIBase::add(const UIBasePtr& element) -> bool
 
     element->isParented_ = true;
     element->parent_ = weak_from_this();
+    element->layoutBase_.setParentLayout(&layoutBase_);
+    element->layoutBase_.markDirty();
     elements_.emplace_back(element);
+    ++topologyVersion_;
     return true;
 }
 
@@ -57,7 +68,7 @@ auto UIBase::add(const UIBasePtrVec& elements) -> void
 
 auto UIBase::remove(const std::function<bool(const UIBasePtr&)>& pred) -> uint32_t
 {
-    return std::erase_if(elements_,
+    const uint32_t removedCount = std::erase_if(elements_,
         [this, pred](const UIBasePtr& e)
         {
             if (pred(e))
@@ -69,10 +80,22 @@ auto UIBase::remove(const std::function<bool(const UIBasePtr&)>& pred) -> uint32
                 }
                 e->parent_.reset();
                 e->isParented_ = false;
+                e->layoutBase_.setParentLayout(nullptr);
                 return true;
             };
             return false;
         });
+
+    /* Remaining elements need to be placed again. If we wrap around them, our scale changed as well.
+        Removed elements were drawn inside our view so redrawing it clears them. */
+    if (removedCount)
+    {
+        ++topologyVersion_;
+        layoutBase_.markDirty(layoutBase_.isFit());
+        layoutBase_.markRenderDirty();
+    }
+
+    return removedCount;
 }
 
 auto UIBase::remove(const UIBasePtr& element) -> bool
@@ -91,11 +114,24 @@ auto UIBase::remove(UIBasePtrVec&& elements) -> void
     std::ranges::for_each(std::move(elements), [this](const UIBasePtr& e){ remove(e); });
 }
 
-auto UIBase::setIgnoreEvents(const bool ignore) -> void { isIgnoringEvents_ = ignore; }
+auto UIBase::setIgnoreEvents(const bool ignore) -> void
+{
+    /* Changes which nodes events can reach, windows need to refresh whatever they cached about it. */
+    if (isIgnoringEvents_ != ignore) { ++topologyVersion_; }
+    isIgnoringEvents_ = ignore;
+}
 
-auto UIBase::setColor(const glm::vec4& value) -> void { baseColor_ = value; }
+auto UIBase::setColor(const glm::vec4& value) -> void
+{
+    if (baseColor_ != value) { layoutBase_.markRenderDirty(); }
+    baseColor_ = value;
+}
 
-auto UIBase::setBorderColor(const glm::vec4& value) -> void { borderColor_ = value; }
+auto UIBase::setBorderColor(const glm::vec4& value) -> void
+{
+    if (borderColor_ != value) { layoutBase_.markRenderDirty(); }
+    borderColor_ = value;
+}
 
 auto UIBase::isParented() -> bool { return isParented_; }
 
@@ -121,6 +157,21 @@ auto UIBase::getBaseLayoutData() -> core::LayoutBase& { return layoutBase_; }
 
 auto UIBase::getEventManager() -> core::Events& { return eventsMgr_; }
 
+auto UIBase::getTopologyVersion() -> uint64_t { return topologyVersion_; }
+
+auto UIBase::subscribeToBroadcast(const uint32_t eventId) -> void
+{
+    broadcastSubscriptions_.emplace_back(eventId);
+    ++topologyVersion_;
+}
+
+auto UIBase::isListeningTo(const uint32_t eventId) const -> bool
+{
+    /* Either the element handles it internally or the user wants it. */
+    return std::ranges::find(broadcastSubscriptions_, eventId) != broadcastSubscriptions_.end()
+        || eventsMgr_.isListeningTo(eventId);
+}
+
 auto operator<<(std::ostream& out, const UIBasePtr& obj) -> std::ostream&
 {
     /* Note: Printing before the first layoutNext() will print elements with an incorrect number of tabs. */
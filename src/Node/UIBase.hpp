@@ -1,8 +1,6 @@
 #pragma once
 
 #include "src/Core/LayoutHandler/LayoutBase.hpp"
-#include "src/Core/ResourceHandler/Mesh.hpp"
-#include "src/Core/ResourceHandler/Shader.hpp"
 #include "src/Core/EventHandler/Events.hpp"
 #include "src/Node/Helpers/UIState.hpp"
 #include "src/Utils/Logger.hpp"
@@ -27,15 +25,12 @@ using UIBasePtrVec = std::vector<UIBasePtr>;
 
 /**
     @brief
-    Each instantiation of UIBase needs to know what vertex/fragment/other shader it needs to load from
-    and additionally a name, used mostly for logging. This is passed via move so no copying occurs. This
-    can be made even more trivial (static structure with default names/shaders) but object creation is not
-    on a critical path anyway and strings are short.*/
+    Each instantiation of UIBase needs a name, used mostly for logging. This is passed via move so no
+    copying occurs. Nodes don't own any GPU state, all of them are drawn by the BatchRenderer with its
+    shared quad and programs.*/
 struct UIBaseInitData
 {
     std::string name;
-    std::filesystem::path vertexShader;
-    std::filesystem::path fragmentShader;
 };
 
 /**
@@ -54,8 +49,8 @@ struct UIBaseInitData
     Exactly what INSERT_TYPEINFO does but additionaly it deletes move/copy constructors, inserts virt descructor
     and defines the basic constructor for receiving @ref `UIBaseInitData`.
 */
-#define INSERT_CONSTRUCT_COPY_MOVE_DEFS(UIElement, vertShader, fragShader)\
-    UIElement(UIBaseInitData&& initData = { #UIElement, vertShader, fragShader });\
+#define INSERT_CONSTRUCT_COPY_MOVE_DEFS(UIElement)\
+    UIElement(UIBaseInitData&& initData = { #UIElement });\
     virtual ~UIElement() = default;\
     UIElement(const UIElement&) = delete;\
     UIElement(UIElement&&) = delete;\
@@ -119,7 +114,7 @@ public: friend class UIWindow;
 
 public:
     UIBase(UIBaseInitData&& initData);
-    virtual ~UIBase() = default;
+    virtual ~UIBase();
     UIBase(const UIBase&) = delete;
     UIBase(UIBase&&) = delete;
     auto operator=(const UIBase&) -> UIBase& = delete;
@@ -148,6 +143,11 @@ public:
     auto getColor() -> glm::vec4;
     auto getBorderColor() -> glm::vec4;
 
+    static auto getTopologyVersion() -> uint64_t;
+
+protected:
+    auto subscribeToBroadcast(const uint32_t eventId) -> void;
+
     /* Print overload */
     friend auto operator<<(std::ostream& out, const UIBasePtr&) -> std::ostream&;
 
@@ -156,7 +156,14 @@ private:
     virtual auto layout() -> void = 0;
     virtual auto event(UIStatePtr& state) -> void = 0;
 
+    /* Visible but not redrawn this frame. Resources render() would use must not be evicted meanwhile. */
+    virtual auto keepResident() -> void {}
+
     static auto demangleName(const char* name) -> std::string;
+    auto isListeningTo(const uint32_t eventId) const -> bool;
+
+    /* Bumped on each add/remove anywhere. Lets windows know their flattened trees are stale. */
+    static uint64_t topologyVersion_;
 
 protected:
     core::LayoutBase layoutBase_;
@@ -167,13 +174,12 @@ protected:
     uint32_t customTagid_;
     uint32_t id_;
     utils::Logger log_;
-    core::Mesh mesh_;
-    core::Shader shader_;
     glm::vec4 baseColor_;
     glm::vec4 borderColor_;
     uint32_t depth_;
     bool isParented_;
     bool isIgnoringEvents_;
+    std::vector<uint32_t> broadcastSubscriptions_;
 };
 } // namespace lav::node
 
@@ -5,6 +5,7 @@
 #include "src/Core/EventHandler/IEvent.hpp"
 #include "src/Utils/Misc.hpp"
 #include "src/Core/LayoutHandler/BasicCalculator.hpp"
+#include "src/Core/RenderHandler/BatchRenderer.hpp"
 #include "src/Core/Binders/GPUBinder.hpp"
 
 namespace lav::node
@@ -19,19 +20,10 @@ UIButton::UIButton(UIBaseInitData&& data) : UIBase(std::move(data))
     add(label_);
 }
 
-auto UIButton::render(const glm::mat4& projection) -> void
+auto UIButton::render(const glm::mat4&) -> void
 {
-    mesh_.bind();
-    shader_.bind();
-    shader_.uploadMat4("uMatrixProjection", projection);
-    shader_.uploadMat4("uMatrixTransform", layoutBase_.getTransform());
-    shader_.uploadVec4f("uColor", overrideColor_ ? *overrideColor_ : getColor());
-    shader_.uploadVec2f("uResolution", layoutBase_.getComputedScale());
-    shader_.uploadVec4f("uBorderSize", layoutBase_.getBorder());
-    shader_.uploadVec4f("uBorderRadii", layoutBase_.getBorderRadius());
-    shader_.uploadVec4f("uBorderColor", getBorderColor());
-    shader_.uploadInt("uUseTexture", 0);
-    core::GPUBinder::get().renderBoundQuad();
+    BatchRenderer::get().pushQuad(BatchRenderer::makeInstance(layoutBase_,
+        overrideColor_ ? *overrideColor_ : getColor(), getBorderColor()));
 }
 
 auto UIButton::layout() -> void
@@ -49,14 +41,14 @@ auto UIButton::event(UIStatePtr& state) -> void
     const auto eId = state->currentEventId;
     if (eId == MouseLeftClickEvt::eventId)
     {
-        overrideColor_ = clickedColor_;
+        setOverrideColor(clickedColor_);
         MouseLeftClickEvt e{state->mousePos.x, state->mousePos.y};
         return eventsMgr_.emitEvent<MouseLeftClickEvt>(e);
     }
     else if (eId == MouseLeftReleaseEvt::eventId)
     {
-        if (state->hoveredId == getId()) { overrideColor_ = hoveredColor_; }
-        else { overrideColor_.reset(); }
+        if (state->hoveredId == getId()) { setOverrideColor(hoveredColor_); }
+        else { setOverrideColor(std::nullopt); }
 
         MouseLeftReleaseEvt e;
         return eventsMgr_.emitEvent<MouseLeftReleaseEvt>(e);
@@ -68,28 +60,36 @@ auto UIButton::event(UIStatePtr& state) -> void
     }
     else if (eId == MouseEnterEvt::eventId)
     {
-        if (state->clickedId != getId()) { overrideColor_ = hoveredColor_; }
+        if (state->clickedId != getId()) { setOverrideColor(hoveredColor_); }
 
         MouseEnterEvt e{state->mousePos.x, state->mousePos.y};
         return eventsMgr_.emitEvent<MouseEnterEvt>(e);
     }
     else if (eId == MouseExitEvt::eventId)
     {
-        if (state->clickedId == getId()) { overrideColor_ = clickedColor_; }
-        else { overrideColor_.reset(); }
+        if (state->clickedId == getId()) { setOverrideColor(clickedColor_); }
+        else { setOverrideColor(std::nullopt); }
 
         MouseExitEvt e{state->mousePos.x, state->mousePos.y};
         return eventsMgr_.emitEvent<MouseExitEvt>(e);
     }
 }
 
+auto UIButton::setOverrideColor(const std::optional<glm::vec4>& color) -> void
+{
+    if (overrideColor_ == color) { return; }
+
+    overrideColor_ = color;
+    layoutBase_.markRenderDirty();
+}
+
 auto UIButton::setClickedColor(const glm::vec4& color) -> UIButton& { clickedColor_ = color; return *this; }
 auto UIButton::setHoveredColor(const glm::vec4& color) -> UIButton& { hoveredColor_ = color; return *this; }
-auto UIButton::setEnabled() -> UIButton& { isBtnEnabled_ = true; overrideColor_.reset(); return *this; }
+auto UIButton::setEnabled() -> UIButton& { isBtnEnabled_ = true; setOverrideColor(std::nullopt); return *this; }
 auto UIButton::setDisabled() -> UIButton&
 {
     isBtnEnabled_ = false;
-    overrideColor_ = utils::hexToVec4("#aaaaaaff");
+    setOverrideColor(utils::hexToVec4("#aaaaaaff"));
     return *this;
 }
 auto UIButton::setText(const std::string& text) -> UIButton& { label_->setText(text); return *this; }
@@ -17,7 +17,7 @@ class UIButton : public UIBase
 {
 public:
     /* Mandatory typeinfo */
-    INSERT_CONSTRUCT_COPY_MOVE_DEFS(UIButton, "elemVert.glsl", "elemFrag.glsl");
+    INSERT_CONSTRUCT_COPY_MOVE_DEFS(UIButton);
     INSERT_ADD_REMOVE_NOT_ALLOWED(UIScroll);
 
     auto setClickedColor(const glm::vec4& color) -> UIButton&;
@@ -34,6 +34,7 @@ private:
     virtual auto render(const glm::mat4& projection) -> void override;
     virtual auto layout() -> void override;
     virtual auto event(UIStatePtr& state) -> void override;
+    auto setOverrideColor(const std::optional<glm::vec4>& color) -> void;
 
 protected:
     UILabelPtr label_{utils::make<UILabel>()};
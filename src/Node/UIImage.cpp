@@ -2,6 +2,8 @@
 
 #include "src/Core/Binders/GPUBinder.hpp"
 #include "src/Core/LayoutHandler/BasicCalculator.hpp"
+#include "src/Core/RenderHandler/BatchRenderer.hpp"
+#include "src/Core/ResourceHandler/ResidencyManager.hpp"
 #include "src/Core/ResourceHandler/TextureLoader.hpp"
 #include "src/Utils/Misc.hpp"
 
@@ -13,22 +15,22 @@ UIImage::UIImage(UIBaseInitData&& initData) : UIBase(std::move(initData))
     layoutBase_.setScale({200_px, 50_px});
 }
 
-auto UIImage::render(const glm::mat4& projection) -> void
+auto UIImage::render(const glm::mat4&) -> void
 {
-    mesh_.bind();
-    shader_.bind();
-    shader_.uploadMat4("uMatrixProjection", projection);
-    shader_.uploadMat4("uMatrixTransform", layoutBase_.getTransform());
-    shader_.uploadVec4f("uColor", baseColor_);
-    shader_.uploadVec4f("uBorderColor", borderColor_);
-    shader_.uploadVec2f("uResolution", layoutBase_.getComputedScale());
-    shader_.uploadVec4f("uBorderSize", layoutBase_.getBorder());
-    shader_.uploadVec4f("uBorderRadii", layoutBase_.getBorderRadius());
-    shader_.uploadInt("uUseTexture", imgTexData_.id);
-    shader_.uploadTexture2D("uTexture", 0, imgTexData_.id);
-    core::GPUBinder::get().renderBoundQuad();
+    using namespace core;
+    auto instance = BatchRenderer::makeInstance(layoutBase_, baseColor_, borderColor_);
+
+    /* Only sample the texture if it's resident. Until then the base color acts as a placeholder. Evicted
+        textures start reloading here. */
+    const bool isResident = ResidencyManager::get().touch(imgTexData_, onTextureReady_);
+    const uint32_t texId = isResident ? imgTexData_->id : 0;
+    instance.params.y = texId ? 0.0f : -1.0f;
+    if (texId) { instance.uvRect = imgTexData_->uvRect; }
+    BatchRenderer::get().pushQuad(instance, texId);
 }
 
+auto UIImage::keepResident() -> void { core::ResidencyManager::get().touch(imgTexData_, onTextureReady_); }
+
 auto UIImage::layout() -> void
 {
     const auto& calculator = core::BasicCalculator::get();
@@ -43,8 +45,24 @@ auto UIImage::event(UIStatePtr&) -> void
 
 auto UIImage::setImage(const std::filesystem::path& path) -> bool
 {
-    imgTexData_ = core::TextureLoader::get().load(path, {});
-    return imgTexData_.id ? true : false;
+    /* Images are mostly icons. Packing them lets a whole toolbar draw with one texture bound. Bigger ones
+        get their own mipmapped texture so they don't alias when shown downscaled. */
+    using Filter = core::GPUBinder::TextureFilter;
+    const core::Texture::Options opts{
+        .packInAtlas = true,
+        .gpuOptions = {.min = Filter::LINEAR_MIPMAP_LINEAR, .generateMipmaps = true, .anisotropy = 4.0f}};
+
+    /* Redraw once the texture lands, if we're still around by then. */
+    onTextureReady_ = [weakSelf = weak_from_this()](const core::TexturePtr&)
+    {
+        if (auto self = std::static_pointer_cast<UIImage>(weakSelf.lock()))
+        {
+            self->layoutBase_.markRenderDirty();
+        }
+    };
+    imgTexData_ = core::TextureLoader::get().loadAsync(path, opts, onTextureReady_);
+    layoutBase_.markRenderDirty();
+    return imgTexData_->state != core::Texture::State::FAILED;
 }
 
 } // namespace lav::node
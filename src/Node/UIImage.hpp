@@ -1,6 +1,7 @@
 #pragma once
 
 #include "src/Core/ResourceHandler/Texture.hpp"
+#include "src/Core/ResourceHandler/TextureLoader.hpp"
 #include "src/Node/UIBase.hpp"
 
 namespace lav::node
@@ -9,19 +10,29 @@ namespace lav::node
 class UIImage : public UIBase
 {
 public:
-    INSERT_CONSTRUCT_COPY_MOVE_DEFS(UIImage, "elemVert.glsl", "elemFrag.glsl");
+    INSERT_CONSTRUCT_COPY_MOVE_DEFS(UIImage);
 
+    /**
+        @brief Set the image to be shown. Loading happens in the background, the element's color is shown
+            until the texture is resident.
+
+        @param path Path to the image
+
+        @return False if the image is already known to fail loading.
+    */
     auto setImage(const std::filesystem::path& path) -> bool;
 
 protected:
     auto render(const glm::mat4& projection) -> void override;
     auto layout() -> void override;
     auto event(UIStatePtr& state) -> void override;
+    auto keepResident() -> void override;
 
     INSERT_ADD_REMOVE_NOT_ALLOWED(UImage);
 
 private:
-    core::Texture imgTexData_;
+    core::TexturePtr imgTexData_;
+    core::TextureLoader::ReadyCallback onTextureReady_;
 };
 using UIImagePtr = std::shared_ptr<UIImage>;
 using UIImageWPtr = std::weak_ptr<UIImage>;
@@ -1,9 +1,11 @@
 #include "UILabel.hpp"
 
+#include <algorithm>
 #include <optional>
 
 #include "src/Core/Binders/GPUBinder.hpp"
 #include "src/Core/EventHandler/IEvent.hpp"
+#include "src/Core/RenderHandler/BatchRenderer.hpp"
 #include "src/Utils/Misc.hpp"
 
 namespace lav::node
@@ -16,36 +18,32 @@ UILabel::UILabel(UIBaseInitData&& data) : UIBase(std::move(data))
     setIgnoreEvents();
 }
 
-auto UILabel::render(const glm::mat4& projection) -> void
+auto UILabel::render(const glm::mat4&) -> void
 {
-    mesh_.bind();
-    shader_.bind();
-    shader_.uploadMat4("uMatrixProjection", projection);
-    shader_.uploadMat4("uMatrixTransform", layoutBase_.getTransform());
-    shader_.uploadVec4f("uColor", overrideColor_ ? *overrideColor_ : getColor());
-    shader_.uploadVec2f("uResolution", layoutBase_.getComputedScale());
-    shader_.uploadVec4f("uBorderSize", layoutBase_.getBorder());
-    shader_.uploadVec4f("uBorderRadii", layoutBase_.getBorderRadius());
-    shader_.uploadVec4f("uBorderColor", getBorderColor());
-    shader_.uploadInt("uUseTexture", 0);
-    core::GPUBinder::get().renderBoundQuad();
-
-    /* Draw the text */
-    const auto& textShader_ = textAttribs_.getShader();
-    const auto& textBuffer = textAttribs_.getBuffer();
-    textShader_.bind();
-    textShader_.uploadVec4f("uColor", utils::hexToVec4("#141414ff"));
-    textShader_.uploadMat4("uMatrixProjection", projection);
-    textShader_.uploadMat4v("uModelMatrices", textBuffer.model);
-    textShader_.uploadIntv("uCharIndices", textBuffer.glyphCode);
-    textShader_.uploadTexture2DArray("uTextureArray", 0, textAttribs_.getFont()->textureId);
-    core::GPUBinder::get().renderBoundQuadInstanced(textAttribs_.getText().size());
+    using namespace core;
+    auto& batch = BatchRenderer::get();
+    batch.pushQuad(BatchRenderer::makeInstance(layoutBase_,
+        overrideColor_ ? *overrideColor_ : getColor(), getBorderColor()));
+
+    /* Draw the text. Gets drawn after all the quads of the window are flushed. */
+    const auto& viewPos = layoutBase_.getViewPos();
+    const auto& viewScale = layoutBase_.getViewScale();
+    textAttribs_.setValidBounds(viewPos, viewScale);
+    batch.pushText(textAttribs_, utils::hexToVec4("#141414ff"), {viewPos.x, viewPos.y, viewScale.x, viewScale.y});
 }
 
 auto UILabel::layout() -> void
 {
-    const glm::vec2 p = layoutBase_.getComputedPos() + layoutBase_.getComputedScale() / 2.0f
-        - textAttribs_.computeMaxSize() / 2.0f;
+    const glm::vec2 contentPos = layoutBase_.getContentBoxPos();
+    const glm::vec2 contentScale = layoutBase_.getContentBoxScale();
+
+    /* Lines are only bounded when something needs to happen once they get too long. */
+    core::TextLayout layout = textLayout_;
+    const bool isBounded = layout.wrap != core::TextLayout::Wrap::NONE || layout.ellipsis;
+    layout.maxWidth = isBounded ? std::max(contentScale.x, 1.0f) : 0.0f;
+    textAttribs_.setLayout(layout);
+
+    const glm::vec2 p = contentPos + glm::max(glm::vec2{0.0f}, (contentScale - textAttribs_.computeMaxSize()) / 2.0f);
     textAttribs_.setPosition({p.x, p.y, layoutBase_.getZIndex()});
 }
 
@@ -80,6 +78,61 @@ auto UILabel::event(UIStatePtr& state) -> void
     }
 }
 
-auto UILabel::setText(const std::string& text) -> UILabel& { textAttribs_.setText(text); return *this; }
+auto UILabel::setText(const std::string& text) -> UILabel&
+{
+    /* Text is placed during layout so it needs a new pass, but only if there's actually something new. */
+    if (textAttribs_.getText() == text) { return *this; }
+
+    textAttribs_.setText(text);
+    layoutBase_.markDirty(false);
+    return *this;
+}
 auto UILabel::setFont(const std::filesystem::path& fontPath) -> void { (void)fontPath; }
+
+auto UILabel::setFont(const core::FontPtr& font) -> UILabel&
+{
+    if (!font || textAttribs_.getFont() == font) { return *this; }
+
+    textAttribs_.setFont(font);
+    layoutBase_.markDirty(false);
+    return *this;
+}
+
+auto UILabel::setWrap(const core::TextLayout::Wrap wrap) -> UILabel&
+{
+    core::TextLayout layout = textLayout_;
+    layout.wrap = wrap;
+    return updateTextLayout(layout);
+}
+
+auto UILabel::setMaxLines(const uint32_t maxLines) -> UILabel&
+{
+    core::TextLayout layout = textLayout_;
+    layout.maxLines = maxLines;
+    return updateTextLayout(layout);
+}
+
+auto UILabel::setEllipsis(const bool value) -> UILabel&
+{
+    core::TextLayout layout = textLayout_;
+    layout.ellipsis = value;
+    return updateTextLayout(layout);
+}
+
+auto UILabel::setLineSpacing(const float spacing) -> UILabel&
+{
+    core::TextLayout layout = textLayout_;
+    layout.lineSpacing = spacing;
+    return updateTextLayout(layout);
+}
+
+auto UILabel::updateTextLayout(const core::TextLayout& layout) -> UILabel&
+{
+    /* Width is only known during layout, so the actual reshape happens there. */
+    if (layout == textLayout_) { return *this; }
+
+    textLayout_ = layout;
+    layoutBase_.markDirty(false);
+    return *this;
+}
 } // namespace src::uinodes
@@ -9,23 +9,76 @@ namespace lav::node
 {
 /**
     @brief Label element for displaying text.
+
+    @note Text is centered inside the content box. When it doesn't fit it starts from the top left instead and
+        whatever overflows is clipped.
 */
 class UILabel : public UIBase
 {
 public:
-    INSERT_CONSTRUCT_COPY_MOVE_DEFS(UILabel, "elemVert.glsl", "elemFrag.glsl");
+    INSERT_CONSTRUCT_COPY_MOVE_DEFS(UILabel);
     INSERT_ADD_REMOVE_NOT_ALLOWED(UILabel);
 
     auto setText(const std::string& text) -> UILabel&;
     auto setFont(const std::filesystem::path& fontPath) -> void;
 
+    /**
+        @brief Use an already loaded font. Needed for fonts loaded in SDF mode or at a non default size.
+
+        @param font Font to use
+
+        @return Myself.
+    */
+    auto setFont(const core::FontPtr& font) -> UILabel&;
+
+    /**
+        @brief Set how text is wrapped against the content box width.
+
+        @param wrap Wrap mode. NONE only breaks on explicit new lines
+
+        @return Myself.
+    */
+    auto setWrap(const core::TextLayout::Wrap wrap) -> UILabel&;
+
+    /**
+        @brief Limit the number of lines shown.
+
+        @param maxLines Lines past this one are dropped. Zero means unlimited
+
+        @return Myself.
+    */
+    auto setMaxLines(const uint32_t maxLines) -> UILabel&;
+
+    /**
+        @brief Mark text that doesn't fit with "...".
+
+        @note Text is truncated at the content box width, so this applies to unwrapped text as well.
+
+        @param value Use an ellipsis or not
+
+        @return Myself.
+    */
+    auto setEllipsis(const bool value) -> UILabel&;
+
+    /**
+        @brief Set the line spacing.
+
+        @param spacing Multiplier of the font's line height
+
+        @return Myself.
+    */
+    auto setLineSpacing(const float spacing) -> UILabel&;
+
 private:
     virtual auto render(const glm::mat4& projection) -> void override;
     virtual auto layout() -> void override;
     virtual auto event(UIStatePtr& state) -> void override;
 
+    auto updateTextLayout(const core::TextLayout& layout) -> UILabel&;
+
 protected:
     core::TextAttribs textAttribs_;
+    core::TextLayout textLayout_;
     std::optional<glm::vec4> overrideColor_{std::nullopt};
 };
 using UILabelPtr = std::shared_ptr<UILabel>;
@@ -3,6 +3,7 @@
 #include "src/Core/Binders/GPUBinder.hpp"
 #include "src/Core/EventHandler/IEvent.hpp"
 #include "src/Core/LayoutHandler/BasicCalculator.hpp"
+#include "src/Core/RenderHandler/BatchRenderer.hpp"
 #include "src/Core/ResourceHandler/Shader.hpp"
 #include "src/Utils/Misc.hpp"
 
@@ -12,21 +13,17 @@ UIPane::UIPane(UIBaseInitData&& initData) : UIBase(std::move(initData))
 {
     using namespace core;
     layoutBase_.setScale({200_px, 50_px});
+
+    /* Button events get re-emitted to the user when we are the hovered element. */
+    subscribeToBroadcast(MouseButtonEvt::eventId);
 }
 
-auto UIPane::render(const glm::mat4& projection) -> void
+auto UIPane::render(const glm::mat4&) -> void
 {
+    using namespace core;
+
     /* Draw base */
-    mesh_.bind();
-    shader_.bind();
-    shader_.uploadMat4("uMatrixProjection", projection);
-    shader_.uploadMat4("uMatrixTransform", layoutBase_.getTransform());
-    shader_.uploadVec4f("uColor", baseColor_);
-    shader_.uploadVec2f("uResolution", layoutBase_.getComputedScale());
-    shader_.uploadVec4f("uBorderSize", layoutBase_.getBorder());
-    shader_.uploadVec4f("uBorderColor", borderColor_);
-    shader_.uploadInt("uUseTexture", 0);
-    core::GPUBinder::get().renderBoundQuad();
+    BatchRenderer::get().pushQuad(BatchRenderer::makeInstance(layoutBase_, baseColor_, borderColor_));
 }
 
 auto UIPane::layout() -> void
@@ -17,7 +17,7 @@ namespace lav::node
 class UIPane : public UIBase
 {
 public:
-    INSERT_CONSTRUCT_COPY_MOVE_DEFS(UIPane, "elemVert.glsl", "elemFrag.glsl");
+    INSERT_CONSTRUCT_COPY_MOVE_DEFS(UIPane);
 
     auto setScrollEnabled(const bool enableH, const bool enableV) -> UIPane&;
     auto setScrollSensitivityMultiplier(const float value) -> UIPane&;
@@ -5,6 +5,7 @@
 #include "src/Node/UILabel.hpp"
 #include "src/Utils/Misc.hpp"
 #include "src/Core/LayoutHandler/BasicCalculator.hpp"
+#include "src/Core/RenderHandler/BatchRenderer.hpp"
 
 namespace lav::node
 {
@@ -20,30 +21,23 @@ UISlider::UISlider(UIBaseInitData&& initData) : UIBase(std::move(initData))
     UIBase::add(label_);
 }
 
-auto UISlider::render(const glm::mat4& projection) -> void
+auto UISlider::render(const glm::mat4&) -> void
 {
+    using namespace core;
+    auto& batch = BatchRenderer::get();
+
     /* Draw base */
-    mesh_.bind();
-    shader_.bind();
-    shader_.uploadMat4("uMatrixProjection", projection);
-    shader_.uploadMat4("uMatrixTransform", layoutBase_.getTransform());
-    shader_.uploadVec4f("uColor", baseColor_);
-    shader_.uploadVec2f("uResolution", layoutBase_.getComputedScale());
-    shader_.uploadVec4f("uBorderSize", layoutBase_.getBorder());
-    shader_.uploadVec4f("uBorderRadii", layoutBase_.getBorderRadius());
-    shader_.uploadVec4f("uBorderColor", borderColor_);
-    shader_.uploadInt("uUseTexture", 0);
-    core::GPUBinder::get().renderBoundQuad();
-
-    /* Draw knob */
-    core::GPUBinder::get().enable(core::GPUBinder::Function::DEPTH, false);
-    shader_.bind();
-    shader_.uploadMat4("uMatrixProjection", projection);
-    shader_.uploadMat4("uMatrixTransform", knobLayout_.getTransform());
-    shader_.uploadVec4f("uColor", knobColor_);
-    shader_.uploadVec2f("uResolution", layoutBase_.getComputedScale());
-    core::GPUBinder::get().renderBoundQuad();
-    core::GPUBinder::get().enable(core::GPUBinder::Function::DEPTH, true);
+    auto instance = BatchRenderer::makeInstance(layoutBase_, baseColor_, borderColor_);
+    batch.pushQuad(instance);
+
+    /* Draw knob. Same border and clip area as the base but slightly in front of it instead of
+        turning off the depth test. */
+    const auto& knobPos = knobLayout_.getComputedPos();
+    const auto& knobScale = knobLayout_.getComputedScale();
+    instance.rect = {knobPos.x, knobPos.y, knobScale.x, knobScale.y};
+    instance.color = knobColor_;
+    instance.params.x += 0.5f;
+    batch.pushQuad(instance);
 }
 
 auto UISlider::layout() -> void
@@ -82,7 +76,7 @@ auto UISlider::event(node::UIStatePtr& state) -> void
     }
     else if (eId == MouseDragEvt::eventId)
     {
-        percentage_ = calculatePercentage(state->mousePos - distToKnobCenter_);
+        updatePercentage(calculatePercentage(state->mousePos - distToKnobCenter_));
 
         SliderEvt sliderEvt{getScrollValue()};
         eventsMgr_.emitEvent<SliderEvt>(sliderEvt);
@@ -96,7 +90,7 @@ auto UISlider::event(node::UIStatePtr& state) -> void
         const glm::ivec2 middle = knobLayout_.getComputedPos() + knobHalf;
         distToKnobCenter_ = state->mousePos - middle;
         distToKnobCenter_ = utils::valueIfLowerAbs(distToKnobCenter_, knobHalf);
-        percentage_ = calculatePercentage(state->mousePos - distToKnobCenter_);
+        updatePercentage(calculatePercentage(state->mousePos - distToKnobCenter_));
 
         SliderEvt sliderEvt{getScrollValue()};
         eventsMgr_.emitEvent<SliderEvt>(sliderEvt);
@@ -137,6 +131,15 @@ auto UISlider::calculatePercentage(const glm::ivec2& mPos) -> float
     return 0.0f;
 }
 
+auto UISlider::updatePercentage(const float value) -> void
+{
+    if (percentage_ == value) { return; }
+
+    /* Knob needs to be moved and if we are a scroll bar, the parent needs to offset it's elements. */
+    percentage_ = value;
+    layoutBase_.markDirty();
+}
+
 auto UISlider::calculateKnobPosition() -> void
 {
     const auto& computedPos = layoutBase_.getComputedPos();
@@ -170,17 +173,20 @@ auto UISlider::getScrollValue() -> float
 
 auto UISlider::setScrollValue(const float value) -> void
 {
-    percentage_ = utils::remap(value, scrollFrom_, scrollTo_, 0.0f, 1.0f);
+    updatePercentage(utils::remap(value, scrollFrom_, scrollTo_, 0.0f, 1.0f));
 }
 
 auto UISlider::setScrollFrom(const float value) -> void
 {
+    if (scrollFrom_ != value) { layoutBase_.markDirty(false); }
     scrollFrom_ = value;
     setText(std::to_string((int)getScrollValue()));
 }
 
 auto UISlider::setScrollTo(const float value) -> void
 {
+    /* Only the knob changes, parent (if scroll bar) already knows about the new range. */
+    if (scrollTo_ != value) { layoutBase_.markDirty(false); }
     scrollTo_ = value;
     setText(std::to_string((int)getScrollValue()));
 }
@@ -12,7 +12,7 @@ namespace lav::node
 class UISlider : public UIBase
 {
 public:
-    INSERT_CONSTRUCT_COPY_MOVE_DEFS(UISlider, "elemVert.glsl", "elemFrag.glsl");
+    INSERT_CONSTRUCT_COPY_MOVE_DEFS(UISlider);
     INSERT_ADD_REMOVE_NOT_ALLOWED(UISlider);
 
     auto getScrollPercentage() -> float;
@@ -36,6 +36,7 @@ protected:
 private:
     auto calculatePercentage(const glm::ivec2& mPos) -> float;
     auto calculateKnobPosition() -> void;
+    auto updatePercentage(const float value) -> void;
 
 protected:
     glm::vec4 knobColor_{utils::hexToVec4("#afafafff")};
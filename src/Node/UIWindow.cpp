@@ -1,18 +1,23 @@
 #include "UIWindow.hpp"
 
 #include <algorithm>
+#include <fstream>
 
 #include "src/App.hpp"
 #include "src/Core/Binders/GPUBinder.hpp"
 #include "src/Core/Binders/WindowBinder.hpp"
 #include "src/Core/EventHandler/IEvent.hpp"
 #include "src/Core/LayoutHandler/BasicCalculator.hpp"
+#include "src/Core/RenderHandler/BatchRenderer.hpp"
+#include "src/Core/ResourceHandler/LoadingQueue.hpp"
+#include "src/Core/ResourceHandler/ResidencyManager.hpp"
 #include "src/Node/Helpers/UIState.hpp"
 #include "src/Node/InternalUse/UIScroll.hpp"
 #include "src/Node/UIBase.hpp"
 // #include "src/Uinodes/UIDropdown.hpp"
 #include "src/Node/UISlider.hpp"
 #include "src/Utils/Misc.hpp"
+#include "src/Utils/Profiler.hpp"
 #include "vendor/glm/ext/matrix_clip_space.hpp"
 
 namespace lav::node
@@ -22,7 +27,7 @@ int32_t UIWindow::MAX_LAYERS = 1000;
 bool UIWindow::isFirstWindow_ = true;
 
 UIWindow::UIWindow(const std::string& title, const glm::ivec2& size)
-    : UIBase({"UIWindow", "elemVert.glsl", "elemFrag.glsl"})
+    : UIBase({"UIWindow"})
     , window_(core::WindowBinder::get().createWindow(title, size))
     , title_(title)
     , isMainWindow_(isFirstWindow_)
@@ -31,26 +36,25 @@ UIWindow::UIWindow(const std::string& title, const glm::ivec2& size)
 
     updateWindowSizeAndProjection(size);
 
-    /* Setup hooks into events */
-    /* TODO: Callbacks like mouseMove/windowResize/mouseScroll
-     fire a lot of times per "frame" creating a lot of unwanted computation.
-     It needs to be dealt with, buffer all calls into a single one. */
+    /* Setup hooks into events. Callbacks like mouseMove/windowResize/mouseScroll fire a lot of times per
+        "frame" so they are only queued here and dispatched all at once at the start of run(). */
+    using Input = PendingInput::Type;
     cbs_ = {
         .keyCallback =
             [this](uint32_t key, uint32_t sc, uint32_t action, uint32_t mods)
-            { keyHook(key, sc, action, mods); },
+            { queueInput(Input::KEY, glm::ivec4(key, sc, action, mods)); },
         .characterCallback = 
             [this](uint32_t cp){ (void)cp; },
         .mouseMoveCallback = 
-            [this](int32_t x, int32_t y) { mouseMoveHook(x, y); },
+            [this](int32_t x, int32_t y) { queueInput(Input::MOUSE_MOVE, {x, y, 0, 0}); },
         .mouseBtnCallback = 
-            [this](uint8_t btn, uint8_t action) { mouseButtonHook(btn, action); },
+            [this](uint8_t btn, uint8_t action) { queueInput(Input::MOUSE_BUTTON, {btn, action, 0, 0}); },
         .mouseScrollCallback = 
-            [this](int8_t xOffset, int8_t yOffset) { mouseScrollHook(xOffset, yOffset); },
+            [this](int8_t xOffset, int8_t yOffset) { queueInput(Input::MOUSE_SCROLL, {xOffset, yOffset, 0, 0}); },
         .windowSizeCallback = 
-            [this](uint32_t x, uint32_t y) { windowResizeHook(x, y); },
+            [this](uint32_t x, uint32_t y) { queueInput(Input::RESIZE, glm::ivec4(x, y, 0, 0)); },
         .windowMouseEntered = 
-            [this](bool entered) { windowMouseEnterHook(entered); },
+            [this](bool entered) { queueInput(Input::MOUSE_ENTER, {entered, 0, 0, 0}); },
         .windowFileDrop =
             [this](int32_t count, const char** paths)
             {
@@ -68,62 +72,443 @@ UIWindow::UIWindow(const std::string& title, const glm::ivec2& size)
 
 UIWindow::~UIWindow()
 {
+    core::GPUBinder::get().deleteFramebuffer(framebuffer_);
+    core::GPUBinder::get().deleteReadback(readback_);
+    for (auto& timer : gpuTimers_) { core::GPUBinder::get().deleteTimerQuery(timer.queryId); }
     core::WindowBinder::get().destroyWindow(window_);
     log_.debug("Window destroyed");
 }
 
 auto UIWindow::run() -> bool
 {
-    const auto& size = uiState_->windowSize;
+    LAV_PROFILE_ZONE("UIWindow::run");
+
+    const auto startTime = std::chrono::steady_clock::now();
+    lastFrameTime_ = startTime;
+
+    /* Requests that are due get served by this frame, later ones stay pending. Whoever asked may have
+        changed things no node knows about, so the damage policies must not skip or clip this frame. */
+    int64_t requestedNs = requestedFrameNs_.load(std::memory_order_relaxed);
+    if (requestedNs <= std::chrono::nanoseconds(startTime.time_since_epoch()).count()
+        && requestedFrameNs_.compare_exchange_strong(requestedNs, NO_FRAME_REQUEST))
+    {
+        isFullyDamaged_ = true;
+    }
+
     core::WindowBinder::get().makeContextCurrent(window_);
-    core::GPUBinder::get().setViewportArea({0, 0, size.x, size.y});
-    core::GPUBinder::get().setScissorsArea({0, 0, size.x, size.y});
-    core::GPUBinder::get().clearColor(utils::hexToVec4("#3d3d3dff"));
-    core::GPUBinder::get().clearAllBufferBits();
+    core::GPUBinder::get().resetStats();
+
+    deliverCapture();
+    collectGpuTimers();
+    writeStatsSnapshot();
+    dispatchQueuedInput();
+
+    /* Resources finished loading in the background. Can mark elements dirty so do it before layout. */
+    core::LoadingQueue::get().drainUploads(uploadBudget_);
+    layoutPass();
+
+    if (uiState_->wantedCursorType.has_value())
+    {
+        core::WindowBinder::get().setStandardCursor(window_, uiState_->wantedCursorType.value());
+        uiState_->currentCursorType = uiState_->wantedCursorType;
+        uiState_->wantedCursorType.reset();
+    }
 
-    processingQueue_.push(shared_from_this());
-    while (!processingQueue_.empty())
+    /* Once per frame. What the previous frame drew is kept, so it's fine to do before rendering. */
+    if (isMainWindow_) { core::ResidencyManager::get().enforceBudget(); }
+
+    /* Frame would be identical to what's already on screen. */
+    const bool hasDamage = isFullyDamaged_ || (damage_.z > 0 && damage_.w > 0);
+    if (redrawPolicy_ != RedrawPolicy::ALWAYS && !hasDamage)
     {
-        UIBasePtr node = processingQueue_.front();
-        processingQueue_.pop();
+        ++skippedFramesCount_;
+        return core::WindowBinder::get().shouldWindowClose(window_) || forcedQuit_;
+    }
+
+    /* Skipped runs don't age textures, what's on screen still uses them. */
+    if (isMainWindow_) { core::ResidencyManager::get().beginFrame(); }
+    renderFrame();
+
+    /* Swap is left out, with vsync on it mostly measures the wait for the display. */
+    using Metric = core::FrameStats::Metric;
+    const auto cpuTime = std::chrono::steady_clock::now() - startTime;
+    frameStats_.push(Metric::CPU_TIME_US, std::chrono::duration<float, std::micro>(cpuTime).count());
+    frameStats_.push(Metric::NODES_LAID_OUT, layoutStats_.nodesLaidOut);
+    frameStats_.push(Metric::DRAW_CALLS, core::GPUBinder::get().getStats().drawCalls);
+
+    core::WindowBinder::get().swapBuffers(window_);
+
+    return core::WindowBinder::get().shouldWindowClose(window_) || forcedQuit_;
+}
+
+auto UIWindow::renderFrame() -> void
+{
+    LAV_PROFILE_ZONE("UIWindow::renderFrame");
+
+    auto& gpuBinder = core::GPUBinder::get();
+    const auto& size = uiState_->windowSize;
+    const glm::ivec4 fullArea{0, 0, size.x, size.y};
+
+    /* Back buffer contents are undefined after a swap so partial redraws need a persistent target. Offscreen
+        windows have no back buffer at all. */
+    const bool isOffscreen = core::WindowBinder::get().isOffscreen();
+    const bool usesFramebuffer = redrawPolicy_ == RedrawPolicy::DAMAGE_RECT || isOffscreen;
+
+    glm::ivec4 drawArea{fullArea};
+    if (usesFramebuffer)
+    {
+        if (framebuffer_.size != size)
+        {
+            gpuBinder.deleteFramebuffer(framebuffer_);
+            framebuffer_ = gpuBinder.createFramebuffer(size);
+            isFullyDamaged_ = true;
+        }
+        gpuBinder.bindFramebuffer(framebuffer_.id);
+
+        if (redrawPolicy_ == RedrawPolicy::DAMAGE_RECT && !isFullyDamaged_)
+        {
+            drawArea = utils::rectIntersection(damage_, fullArea);
+        }
+    }
+
+    /* Results come back a few frames later. With every timer still waiting the frame goes untimed. */
+    GpuTimer& gpuTimer = gpuTimers_[nextGpuTimer_];
+    const bool isTimed = !gpuTimer.isPending;
+    if (isTimed)
+    {
+        if (!gpuTimer.queryId) { gpuTimer.queryId = gpuBinder.createTimerQuery(); }
+        gpuBinder.beginTimerQuery(gpuTimer.queryId);
+    }
+
+    /* Scissor works from the bottom left corner while the area is from the top left. */
+    gpuBinder.setViewportArea(fullArea);
+    gpuBinder.setScissorsArea({drawArea.x, size.y - drawArea.y - drawArea.w, drawArea.z, drawArea.w});
+    gpuBinder.clearColor(utils::hexToVec4("#3d3d3dff"));
+    gpuBinder.clearAllBufferBits();
+
+    frameStats_.push(core::FrameStats::Metric::NODES_RENDERED, renderPass(drawArea));
+    ++renderedFramesCount_;
+
+    /* Read before blitting, the blit leaves the screen bound. */
+    if (pendingCapture_ && !inFlightCapture_)
+    {
+        gpuBinder.startReadback(readback_, usesFramebuffer ? framebuffer_.id : 0, size);
+        inFlightCapture_ = std::move(pendingCapture_);
+        pendingCapture_ = nullptr;
+        inFlightFrame_ = renderedFramesCount_;
+    }
+
+    if (usesFramebuffer && !isOffscreen)
+    {
+        gpuBinder.blitFramebufferToScreen(framebuffer_);
+    }
+
+    if (isTimed)
+    {
+        gpuBinder.endTimerQuery();
+        gpuTimer.isPending = true;
+        nextGpuTimer_ = (nextGpuTimer_ + 1) % gpuTimers_.size();
+    }
+
+    damage_ = glm::ivec4{0};
+
+    /* Still waiting on a capture means one more frame is needed. */
+    isFullyDamaged_ = static_cast<bool>(pendingCapture_);
+}
+
+auto UIWindow::deliverCapture() -> void
+{
+    auto& gpuBinder = core::GPUBinder::get();
+    if (!inFlightCapture_ || !gpuBinder.isReadbackReady(readback_)) { return; }
+
+    /* Callback is free to ask for another capture. */
+    CaptureCallback onCaptured = std::move(inFlightCapture_);
+    inFlightCapture_ = nullptr;
+
+    FrameCapture capture;
+    capture.size = readback_.size;
+    capture.frame = inFlightFrame_;
+    if (gpuBinder.finishReadback(readback_, capture.pixels)) { onCaptured(capture); }
+}
+
+auto UIWindow::collectGpuTimers() -> void
+{
+    for (auto& timer : gpuTimers_)
+    {
+        if (!timer.isPending) { continue; }
+
+        const auto elapsedNs = core::GPUBinder::get().getTimerQueryResult(timer.queryId);
+        if (!elapsedNs) { continue; }
+        timer.isPending = false;
+
+        /* Some drivers (llvmpipe) answer the very first query with a raw timestamp. */
+        if (*elapsedNs >= MAX_GPU_FRAME_TIME_NS) { continue; }
+        frameStats_.push(core::FrameStats::Metric::GPU_TIME_US, *elapsedNs / 1000.0f);
+    }
+}
+
+auto UIWindow::writeStatsSnapshot() -> void
+{
+    if (statsSnapshotPath_.empty()) { return; }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - lastStatsSnapshot_ < statsSnapshotPeriod_) { return; }
+    lastStatsSnapshot_ = now;
+
+    std::ofstream out{statsSnapshotPath_, std::ios::app};
+    if (!out.is_open())
+    {
+        log_.error("Couldn't open '{}' for frame stats, snapshots disabled", statsSnapshotPath_.string());
+        statsSnapshotPath_.clear();
+        return;
+    }
+    frameStats_.writeSnapshot(out, title_, core::WindowBinder::get().getTime());
+}
+
+auto UIWindow::layoutPass() -> void
+{
+    LAV_PROFILE_ZONE("UIWindow::layoutPass");
+
+    layoutStats_ = {};
+    syncFlatNodes();
+    layoutStats_.nodesTotal = flatNodes_.size();
+
+    /* Parents always come before their children so view boxes computed by a parent are ready by
+        the time we reach the child. Clean subtrees are skipped whole. */
+    for (uint32_t i = 0; i < flatNodes_.size();)
+    {
+        UIBase* node = flatNodes_[i].node;
+        if (!needsLayoutVisit(node))
+        {
+            i = flatNodes_[i].subtreeEnd;
+            continue;
+        }
+        ++layoutStats_.nodesVisited;
+
+        /* Flags are cleared before doing the work so anything invalidated by the work itself is picked
+            up by the next pass instead of being lost. */
+        auto& nLayout = node->layoutBase_;
+        const bool isSelfDamaged = nLayout.isDirty() || nLayout.isViewDirty() || nLayout.isRenderDirty();
+        nLayout.clearSubtreeDirty();
 
         /*
-            Note: Pre and post need to always be done even if preconditions are not satisfied to calculate
-            the layout. This is due to fast layout changes (think rescaling the window fast) skipping some
-            of the viewScale/Pos calculations. Rendering doesn't have this problem as view variables are
-            already computed.
+            Note: Nodes that don't satisfy the preconditions stay dirty. They will be visited again once
+            their view box changes, which is what makes them visible in the first place.
         */
         preLayoutSetup(node);
-        if (areLayoutPreconditionsSatisfied(node))
+        const bool needsLayout = nLayout.isDirty() && areLayoutPreconditionsSatisfied(node);
+        if (needsLayout)
         {
-            node->layout();
+            nLayout.clearDirty();
+            {
+                LAV_PROFILE_ZONE_TAGGED("UIBase::layout", node->nameTag_, node->id_);
+                node->layout();
+            }
+            ++layoutStats_.nodesLaidOut;
+
+            /* Some nodes (panes showing/hiding their scrollbars) change their children while laying out. */
+            if (!resyncFlatNodes(node, i)) { break; }
         }
-        postLayoutActions(node);
 
-        if (areRenderPreconditionsSatisfied(node))
+        /* Children view boxes change only if they just got placed or if our own view box changed. */
+        if (needsLayout || nLayout.isViewDirty())
         {
-            preRenderSetup(node, projection_);
+            nLayout.clearViewDirty();
+            postLayoutActions(node);
+            isHitGridDirty_ = true;
+        }
+
+        if (isSelfDamaged) { damage_ = utils::rectUnion(damage_, nLayout.consumeDamage()); }
+
+        ++i;
+    }
+}
+
+auto UIWindow::renderPass(const glm::ivec4& drawArea) -> uint32_t
+{
+    /* Nodes only push their quads here, actual drawing happens in a few calls at the end. */
+    auto& batch = core::BatchRenderer::get();
+    batch.begin(projection_, uiState_->windowSize, drawArea);
+
+    syncFlatNodes();
+    uint32_t nodesRendered{0};
+    for (const auto& flatNode : flatNodes_)
+    {
+        UIBase* node = flatNode.node;
+
+        /* Nodes fully outside of the area would be scissored out anyway. */
+        const auto& nLayout = node->getBaseLayoutData();
+        const glm::ivec4 visibleArea = utils::rectIntersection({nLayout.getViewPos(), nLayout.getViewScale()}, drawArea);
+        if (!areRenderPreconditionsSatisfied(node)) { continue; }
+
+        if (visibleArea.z > 0 && visibleArea.w > 0)
+        {
+            LAV_PROFILE_ZONE_TAGGED("UIBase::render", node->nameTag_, node->id_);
             node->render(projection_);
             postRenderActions(node);
+            ++nodesRendered;
+        }
+        else
+        {
+            /* Still on screen from an earlier frame, only outside of this partial redraw. */
+            node->keepResident();
         }
+    }
+
+    batch.end();
+    return nodesRendered;
+}
 
-        for (const auto& childNode : node->getElements()) { processingQueue_.push(childNode); }
+auto UIWindow::syncFlatNodes() -> void
+{
+    if (flatNodesVersion_ == UIBase::getTopologyVersion() && !flatNodes_.empty()) { return; }
+
+    flatNodes_.clear();
+    nodeIndexById_.clear();
+    broadcastRecipients_.clear();
+    flattenSubtree(this, true);
+    flatNodesVersion_ = UIBase::getTopologyVersion();
+}
+
+auto UIWindow::flattenSubtree(UIBase* node, bool isReachable) -> void
+{
+    const uint32_t index = flatNodes_.size();
+    flatNodes_.emplace_back(FlatNode{.node = node, .subtreeEnd = 0});
+
+    /* Nodes under one that ignores events can't be targeted either. */
+    isReachable = isReachable && !node->isIgnoringEvents();
+    if (isReachable) { nodeIndexById_[node->getId()] = index; }
+
+    for (const auto& childNode : node->elements_) { flattenSubtree(childNode.get(), isReachable); }
+    flatNodes_[index].subtreeEnd = flatNodes_.size();
+}
+
+auto UIWindow::getBroadcastRecipients(const uint32_t eventId) -> const std::vector<uint32_t>&
+{
+    /* New listeners may show up without the tree changing. */
+    if (recipientsListenersVersion_ != core::Events::getListenersVersion())
+    {
+        broadcastRecipients_.clear();
+        recipientsListenersVersion_ = core::Events::getListenersVersion();
     }
 
-    if (uiState_->wantedCursorType.has_value())
+    const auto [it, isNew] = broadcastRecipients_.try_emplace(eventId);
+    if (!isNew) { return it->second; }
+
+    /* Kept in tree order so the dispatch order is the same as walking the tree. */
+    auto& recipients = it->second;
+    for (uint32_t i = 0; i < flatNodes_.size();)
     {
-        core::WindowBinder::get().setStandardCursor(window_, uiState_->wantedCursorType.value());
-        uiState_->currentCursorType = uiState_->wantedCursorType;
-        uiState_->wantedCursorType.reset();
+        UIBase* node = flatNodes_[i].node;
+        if (node->isIgnoringEvents())
+        {
+            i = flatNodes_[i].subtreeEnd;
+            continue;
+        }
+
+        if (node->isListeningTo(eventId)) { recipients.emplace_back(i); }
+        ++i;
     }
 
-    core::WindowBinder::get().swapBuffers(window_);
+    return recipients;
+}
 
-    return core::WindowBinder::get().shouldWindowClose(window_) || forcedQuit_;
+auto UIWindow::resyncFlatNodes(const UIBase* node, uint32_t& index) -> bool
+{
+    if (flatNodesVersion_ == UIBase::getTopologyVersion()) { return true; }
+
+    syncFlatNodes();
+    const auto it = std::ranges::find(flatNodes_, node, &FlatNode::node);
+    if (it == flatNodes_.end())
+    {
+        /* Node removed itself or one of its parents, the old order is meaningless from here on. */
+        log_.debug("Node got detached mid traversal, stopping the walk");
+        return false;
+    }
+
+    index = std::distance(flatNodes_.begin(), it);
+    return true;
 }
 
 auto UIWindow::quit() -> void { forcedQuit_ = true; }
 
+auto UIWindow::getLayoutStats() const -> const LayoutStats& { return layoutStats_; }
+
+auto UIWindow::setRedrawPolicy(const RedrawPolicy policy) -> void
+{
+    if (redrawPolicy_ == policy) { return; }
+
+    /* Offscreen target is only needed for partial redraws. */
+    if (policy != RedrawPolicy::DAMAGE_RECT) { core::GPUBinder::get().deleteFramebuffer(framebuffer_); }
+
+    redrawPolicy_ = policy;
+    isFullyDamaged_ = true;
+}
+
+auto UIWindow::getRedrawPolicy() const -> RedrawPolicy { return redrawPolicy_; }
+
+auto UIWindow::getSkippedFramesCount() const -> uint64_t { return skippedFramesCount_; }
+auto UIWindow::getRenderedFramesCount() const -> uint64_t { return renderedFramesCount_; }
+
+auto UIWindow::requestFrame(const std::chrono::milliseconds delay) -> void
+{
+    const auto frameTime = std::chrono::steady_clock::now() + delay;
+    const int64_t wantedNs = std::chrono::nanoseconds(frameTime.time_since_epoch()).count();
+
+    int64_t currentNs = requestedFrameNs_.load(std::memory_order_relaxed);
+    while (wantedNs < currentNs && !requestedFrameNs_.compare_exchange_weak(currentNs, wantedNs)) {}
+
+    /* Loop may be asleep with a later deadline in mind. */
+    core::WindowBinder::get().postEmptyEvent();
+}
+
+auto UIWindow::setTargetFrameRate(const uint32_t fps) -> void
+{
+    using namespace std::chrono;
+    minFrameInterval_ = fps
+        ? duration_cast<steady_clock::duration>(duration<double>(1.0 / fps))
+        : steady_clock::duration{0};
+}
+
+auto UIWindow::getNextFrameTime(const bool continuous) -> std::optional<std::chrono::steady_clock::time_point>
+{
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point earliest = lastFrameTime_ + minFrameInterval_;
+
+    std::optional<Clock::time_point> frameTime;
+    if (continuous || hasPendingFrameWork()) { frameTime = earliest; }
+
+    const int64_t requestedNs = requestedFrameNs_.load(std::memory_order_relaxed);
+    if (requestedNs != NO_FRAME_REQUEST)
+    {
+        const Clock::time_point requested{
+            std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds{requestedNs})};
+        frameTime = std::min(frameTime.value_or(Clock::time_point::max()), std::max(requested, earliest));
+    }
+
+    return frameTime;
+}
+
+auto UIWindow::hasPendingFrameWork() -> bool
+{
+    /* Closing also needs a run(), that's where it gets noticed. */
+    return !pendingInputs_.empty()
+        || isFullyDamaged_
+        || (damage_.z > 0 && damage_.w > 0)
+        || needsLayoutVisit(this)
+        || pendingCapture_
+        || inFlightCapture_
+        || forcedQuit_
+        || core::WindowBinder::get().shouldWindowClose(window_);
+}
+
+auto UIWindow::captureFrame(CaptureCallback onCaptured) -> void
+{
+    pendingCapture_ = std::move(onCaptured);
+    isFullyDamaged_ = true;
+}
+auto UIWindow::setUploadBudget(const std::chrono::microseconds budget) -> void { uploadBudget_ = budget; }
+
 auto UIWindow::render(const glm::mat4& projection) -> void { (void)projection; }
 
 auto UIWindow::layout() -> void
@@ -168,6 +553,84 @@ auto UIWindow::event(UIStatePtr& state) -> void
     }
 }
 
+auto UIWindow::queueInput(const PendingInput::Type type, const glm::ivec4& args) -> void
+{
+    using Input = PendingInput::Type;
+    ++inputStats_.received;
+
+    /* Only back to back inputs of the same kind are merged. Anything in between (like a click) needs to
+        see the state from the moment it happened. */
+    if (!pendingInputs_.empty() && pendingInputs_.back().type == type)
+    {
+        auto& last = pendingInputs_.back();
+        switch (type)
+        {
+            /* Mouse diff is computed against the last dispatched position so it accumulates by itself. */
+            case Input::MOUSE_MOVE:
+            case Input::RESIZE:
+                last.args = args;
+                return;
+            case Input::MOUSE_SCROLL:
+                last.args += args;
+                return;
+            default:
+                break;
+        }
+    }
+
+    pendingInputs_.emplace_back(PendingInput{.type = type, .args = args});
+}
+
+auto UIWindow::dispatchQueuedInput() -> void
+{
+    LAV_PROFILE_ZONE("UIWindow::dispatchQueuedInput");
+
+    using Input = PendingInput::Type;
+    inputStats_.dispatched = 0;
+
+    /* Hooks may end up queueing more input (i.e. moving the cursor programmatically), swap first. */
+    dispatchingInputs_.clear();
+    std::swap(dispatchingInputs_, pendingInputs_);
+    for (const auto& input : dispatchingInputs_)
+    {
+        const auto& a = input.args;
+        switch (input.type)
+        {
+            case Input::KEY:
+                keyHook(a.x, a.y, a.z, a.w);
+                break;
+            case Input::MOUSE_MOVE:
+                mouseMoveHook(a.x, a.y);
+                break;
+            case Input::MOUSE_BUTTON:
+                mouseButtonHook(a.x, a.y);
+                break;
+            case Input::MOUSE_SCROLL:
+                mouseScrollHook(a.x, a.y);
+                break;
+            case Input::RESIZE:
+                windowResizeHook(a.x, a.y);
+                break;
+            case Input::MOUSE_ENTER:
+                windowMouseEnterHook(a.x);
+                break;
+        }
+        ++inputStats_.dispatched;
+    }
+}
+
+auto UIWindow::getInputStats() const -> const InputStats& { return inputStats_; }
+
+auto UIWindow::getFrameStats() const -> const core::FrameStats& { return frameStats_; }
+
+auto UIWindow::setStatsSnapshotFile(const std::filesystem::path& filePath,
+    const std::chrono::milliseconds period) -> void
+{
+    statsSnapshotPath_ = filePath;
+    statsSnapshotPeriod_ = period;
+    lastStatsSnapshot_ = std::chrono::steady_clock::now();
+}
+
 auto UIWindow::windowResizeHook(const uint32_t x, const uint32_t y) -> void
 {
     /* Note: use framebuffer size to set viewport in case DPI is not a default
@@ -206,11 +669,44 @@ auto UIWindow::keyHook(const uint32_t key, const uint32_t, const uint32_t action
     else if (key == Key::P)
     {
         log_.debug("\n{}", shared_from_this());
+
+        /* Counters are reset at the start of each run() so these are for the last frame only. */
+        const auto& gpuStats = GPUBinder::get().getStats();
+        const auto& batchStats = BatchRenderer::get().getStats();
+        log_.debug("Last frame: {} GL calls ({} redundant skipped), {} draw calls, {} uniform uploads, "
+            "{} location queries, {} quads", gpuStats.glCalls, gpuStats.redundantCallsSkipped, gpuStats.drawCalls,
+            gpuStats.uniformUploads, gpuStats.locationQueries, batchStats.instances);
+        log_.debug("Last frame: {}/{} nodes visited, {} nodes laid out, {} frames skipped so far",
+            layoutStats_.nodesVisited, layoutStats_.nodesTotal, layoutStats_.nodesLaidOut, skippedFramesCount_);
+
+        log_.debug("Input: {} callbacks received so far, {} dispatched last frame",
+            inputStats_.received, inputStats_.dispatched);
+
+        const auto& hitStats = hitGrid_.getStats();
+        log_.debug("Hit grid: {} rebuilds, {} queries, {} candidates tested so far",
+            hitStats.rebuilds, hitStats.queries, hitStats.candidatesTested);
+
+        const auto cpu = frameStats_.getPercentiles(FrameStats::Metric::CPU_TIME_US);
+        const auto gpu = frameStats_.getPercentiles(FrameStats::Metric::GPU_TIME_US);
+        log_.debug("Frame time (us): cpu p50 {} p95 {} p99 {}, gpu p50 {} p95 {} p99 {}, over {} frames",
+            cpu.p50, cpu.p95, cpu.p99, gpu.p50, gpu.p95, gpu.p99, cpu.samples);
+    }
+    else if (key == Key::T)
+    {
+        /* First press starts recording, the next one stops it and dumps the last few thousand zones of every
+            thread. Open in chrome://tracing or ui.perfetto.dev. */
+        auto& profiler = utils::Profiler::get();
+        const bool wasEnabled = profiler.isEnabled();
+        profiler.setEnabled(!wasEnabled);
+        if (wasEnabled) { profiler.dumpChromeTrace("lav_trace.json"); }
+        else { log_.info("Profiler recording, press T again to dump the trace"); }
     }
 }
 
 auto UIWindow::mouseMoveHook(const int32_t newX, const int32_t newY) -> void
 {
+    LAV_PROFILE_ZONE("UIWindow::mouseMoveHook");
+
     using namespace core;
 
     const glm::ivec2 newMouse = utils::clamp({newX, newY}, {0, 0}, uiState_->windowSize);
@@ -304,19 +800,38 @@ auto UIWindow::initializeDefaultCursors() -> void
 auto UIWindow::propagateEventTo(const core::IEvent& evt,
     const std::optional<uint32_t> nodeId) -> void
 {
-    uiState_->currentEventId = evt.getEventId();
+    const uint32_t eventId = evt.getEventId();
+    LAV_PROFILE_ZONE_TAGGED("UIWindow::propagateEventTo", "event", eventId);
+    uiState_->currentEventId = eventId;
+    syncFlatNodes();
 
-    processingQueue_.push(shared_from_this());
-    while (!processingQueue_.empty())
+    if (nodeId)
     {
-        UIBasePtr node = processingQueue_.front();
-        processingQueue_.pop();
+        const auto it = nodeIndexById_.find(nodeId.value());
+        if (it == nodeIndexById_.end()) { return; }
+
+        /* User callbacks can add/remove nodes, including this one. */
+        UIBase* node = flatNodes_[it->second].node;
+        const UIBasePtr keepAlive = node->shared_from_this();
+        node->event(uiState_);
+        return;
+    }
 
-        if (node->isIgnoringEvents()) { continue; }
+    /* Broadcasts only go to the nodes interested in them. */
+    const std::vector<uint32_t>* recipients = &getBroadcastRecipients(eventId);
+    for (uint32_t i = 0; i < recipients->size(); ++i)
+    {
+        uint32_t flatIndex = (*recipients)[i];
+        UIBase* node = flatNodes_[flatIndex].node;
+        const UIBasePtr keepAlive = node->shared_from_this();
+        node->event(uiState_);
 
-        if (!nodeId || nodeId.value() == node->getId()) { node->event(uiState_); }
+        if (flatNodesVersion_ == UIBase::getTopologyVersion()) { continue; }
 
-        for (const auto& childNode : node->getElements()) { processingQueue_.push(childNode); }
+        /* Tree changed under us, carry on with whoever comes after this node in the new tree. */
+        if (!resyncFlatNodes(node, flatIndex)) { return; }
+        recipients = &getBroadcastRecipients(eventId);
+        i = std::distance(recipients->begin(), std::ranges::upper_bound(*recipients, flatIndex)) - 1;
     }
 }
 
@@ -325,11 +840,17 @@ auto UIWindow::updateWindowSizeAndProjection(const glm::ivec2 newSize) -> void
     uiState_->windowSizeDelta = newSize - uiState_->windowSize;
     uiState_->windowSize = newSize;
 
+    /* Whole tree depends on the window size. */
+    layoutBase_.setComputedScale(newSize);
+    layoutBase_.markDirty();
+    isFullyDamaged_ = true;
+    isHitGridDirty_ = true;
+
     /* Camera is looking into -Z by default. Here, higher Z means closer to the camera. */
     projection_ = glm::ortho(0.0f, (float)newSize.x, (float)newSize.y, 0.0f, -(float)MAX_LAYERS, 0.0f);
 }
 
-auto UIWindow::areRenderPreconditionsSatisfied(const UIBasePtr& node) -> bool
+auto UIWindow::areRenderPreconditionsSatisfied(UIBase* node) -> bool
 {
     //TODO: Do not render nodes that aint visible
     if (!node || !node->isParented()) { return false; }
@@ -344,7 +865,7 @@ auto UIWindow::areRenderPreconditionsSatisfied(const UIBasePtr& node) -> bool
     return viewScale.x > 0 && viewScale.y > 0;
 }
 
-auto UIWindow::areLayoutPreconditionsSatisfied(const UIBasePtr& node) -> bool
+auto UIWindow::areLayoutPreconditionsSatisfied(UIBase* node) -> bool
 {
     if (node->getTypeId() == UIWindow::typeId)
     {
@@ -356,21 +877,13 @@ auto UIWindow::areLayoutPreconditionsSatisfied(const UIBasePtr& node) -> bool
     return viewScale.x > 0 && viewScale.y > 0;
 }
 
-auto UIWindow::preRenderSetup(const UIBasePtr& node, const glm::mat4& projection) -> void
+auto UIWindow::needsLayoutVisit(UIBase* node) -> bool
 {
     const auto& nLayout = node->getBaseLayoutData();
-    const auto& viewPos = nLayout.getViewPos();
-    const auto& viewScale = nLayout.getViewScale();
-    core::GPUBinder::get().setScissorsArea(
-        {
-            viewPos.x,
-            std::round((-2.0f / projection[1][1])) - viewPos.y - viewScale.y,
-            viewScale.x,
-            viewScale.y
-        });
+    return nLayout.isDirty() || nLayout.isViewDirty() || nLayout.isSubtreeDirty() || nLayout.isRenderDirty();
 }
 
-auto UIWindow::preLayoutSetup(const UIBasePtr& node) -> void
+auto UIWindow::preLayoutSetup(UIBase* node) -> void
 {
     /* If is the root window element or dropdown, scissor area is the whole node area. */
     // if (node->getTypeId() == UIWindow::typeId || node->getTypeId() == UIDropdown::typeId)
@@ -384,48 +897,60 @@ auto UIWindow::preLayoutSetup(const UIBasePtr& node) -> void
 
 auto UIWindow::propagateHoverScanEvent() -> void
 {
-    /* TODO: Propagate functions work at nodeId level and each time we propagate something we need to
-    go thru the tree and find the node, it's very inefficient.
-    We could minimize the overhead by processing all the "queued" events in one pass.
-    Maybe we could send the events in the run() processingQueue loop to have only one master loop over the
-    entire tree, but not sure how that will affect the elements, we might process the event and that event
-    changes the UI but the change is not reflected until the next loop. 
-    However there's nothing stopping us from signaling the window a new loop pass needs to be done from events. */
-    uint32_t maxZIndex{0};
-
-    processingQueue_.push(shared_from_this());
-    while (!processingQueue_.empty())
+    /* We need to ensure that the user's input will go to the highest index element. */
+    if (const uint32_t hitId = hitTest(uiState_->mousePos); hitId != NOTHING)
     {
-        UIBasePtr node = processingQueue_.front();
-        processingQueue_.pop();
+        uiState_->hoveredId = hitId;
+    }
+}
+
+auto UIWindow::hitTest(const glm::ivec2& point) -> uint32_t
+{
+    /* Callbacks may have changed the tree since the last layout pass. */
+    if (isHitGridDirty_ || hitGridVersion_ != UIBase::getTopologyVersion()) { rebuildHitGrid(); }
+    return hitGrid_.query(point);
+}
+
+auto UIWindow::getHitGridStats() const -> const core::HitGrid::Stats& { return hitGrid_.getStats(); }
 
-        if (node->isIgnoringEvents()) { continue; }
+auto UIWindow::rebuildHitGrid() -> void
+{
+    LAV_PROFILE_ZONE("UIWindow::rebuildHitGrid");
 
-        /* Determine in the scan pass who's the hovered element. We need to ensure that the user's input will
-            go to the highest index element. */
-        if (node->layoutBase_.getZIndex() > maxZIndex && node->layoutBase_.isPointInsideView(uiState_->mousePos))
+    syncFlatNodes();
+    hitGrid_.reset(uiState_->windowSize);
+    for (uint32_t i = 0; i < flatNodes_.size();)
+    {
+        UIBase* node = flatNodes_[i].node;
+        if (node->isIgnoringEvents())
         {
-            uiState_->hoveredId = node->getId();
-            maxZIndex = node->layoutBase_.getZIndex();
+            i = flatNodes_[i].subtreeEnd;
+            continue;
         }
 
-        for (const auto& childNode : node->getElements()) { processingQueue_.push(childNode); }
+        const auto& nLayout = node->layoutBase_;
+        hitGrid_.insert(node->getId(), {nLayout.getViewPos(), nLayout.getViewScale()}, nLayout.getZIndex());
+        ++i;
     }
+    hitGrid_.build();
+
+    hitGridVersion_ = UIBase::getTopologyVersion();
+    isHitGridDirty_ = false;
 }
 
-auto UIWindow::postRenderActions(const UIBasePtr& node) -> void
+auto UIWindow::postRenderActions(UIBase* node) -> void
 {
     // Nothing big for now
     (void)node;
 }
 
-auto UIWindow::postLayoutActions(const UIBasePtr& node) -> void
+auto UIWindow::postLayoutActions(UIBase* node) -> void
 {
     /* After calculating myself , compute how much of them is still visible inside of the parent.
         The elements of a dropdown will always be fully visible aka their view scale and pos is their
         actual computed scale and pos. */
     std::ranges::for_each(node->getElements(),
-        [&node](const auto& it)
+        [node](const auto& it)
         {
             auto& itLayout = it->getBaseLayoutData();
             const auto& nodeLayout = node->getBaseLayoutData();
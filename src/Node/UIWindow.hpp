@@ -1,11 +1,22 @@
 #pragma once
 
-#include <queue>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 #include "src/Node/UIBase.hpp"
 #include "src/Core/EventHandler/IEvent.hpp"
 #include "src/Node/Helpers/UIState.hpp"
+#include "src/Core/Binders/GPUBinder.hpp"
 #include "src/Core/Binders/WindowBinder.hpp"
+#include "src/Core/LayoutHandler/HitGrid.hpp"
+#include "src/Core/RenderHandler/FrameStats.hpp"
 
 namespace lav::node
 {
@@ -18,6 +29,71 @@ namespace lav::node
 */
 class UIWindow : public UIBase
 {
+public:
+    /**
+        @brief Decides when and how much of the window gets redrawn.
+
+        @details ALWAYS - Redraw the whole window each run(). Default.
+        @details ON_DAMAGE - Redraw the whole window only if something changed since the last frame.
+        @details DAMAGE_RECT - Redraw only the area that changed. Needs an extra offscreen target.
+    */
+    enum class RedrawPolicy : uint8_t { ALWAYS, ON_DAMAGE, DAMAGE_RECT };
+
+    /** @brief Pixels of a rendered frame. */
+    struct FrameCapture
+    {
+        glm::ivec2 size{0, 0};
+        std::vector<uint8_t> pixels; /* RGBA8, top row first */
+        uint64_t frame{0};           /* Index of the rendered frame the pixels come from */
+    };
+
+    using CaptureCallback = std::function<void(const FrameCapture&)>;
+
+    /** @brief Counters of the last layout pass. */
+    struct LayoutStats
+    {
+        uint32_t nodesTotal{0};
+        uint32_t nodesVisited{0};
+        uint32_t nodesLaidOut{0};
+    };
+
+private:
+    /**
+        @brief Entry of the pre-order flattened tree.
+
+        @note Children of a node are at [index + 1, subtreeEnd). Nodes are kept alive by the tree itself,
+            entries are only valid until the next topology change.
+    */
+    struct FlatNode
+    {
+        UIBase* node{nullptr};
+        uint32_t subtreeEnd{0};
+    };
+
+    /** @brief Raw input callback waiting to be dispatched at the start of the next run(). */
+    struct PendingInput
+    {
+        enum class Type : uint8_t { KEY, MOUSE_MOVE, MOUSE_BUTTON, MOUSE_SCROLL, RESIZE, MOUSE_ENTER };
+
+        Type type{Type::KEY};
+        glm::ivec4 args{0}; /* Callback arguments, in the order the callback receives them. */
+    };
+
+    /** @brief GPU timer of one frame. Pending until the GPU got through that frame. */
+    struct GpuTimer
+    {
+        uint32_t queryId{0};
+        bool isPending{false};
+    };
+
+public:
+    /** @brief Input counters. `received` is cumulative, `dispatched` is for the last run(). */
+    struct InputStats
+    {
+        uint64_t received{0};
+        uint32_t dispatched{0};
+    };
+
 public:
     UIWindow(const std::string& title, const glm::ivec2& size);
     virtual ~UIWindow();
@@ -33,6 +109,81 @@ public:
     auto getTitle() -> std::string;
     auto getWindow() -> core::WindowHandle;
     auto isMainWindow() -> bool;
+    auto getLayoutStats() const -> const LayoutStats&;
+    auto setRedrawPolicy(const RedrawPolicy policy) -> void;
+    auto getRedrawPolicy() const -> RedrawPolicy;
+    auto getSkippedFramesCount() const -> uint64_t;
+    auto getRenderedFramesCount() const -> uint64_t;
+
+    /**
+        @brief Ask for a frame even if nothing changed, i.e to advance an animation or a timer.
+
+        @note Can be called from any thread. Wakes up the render loop if it's sleeping.
+        @note The requested frame is drawn in full, whatever the redraw policy.
+
+        @param delay Time until the frame is wanted. The earliest pending request wins
+    */
+    auto requestFrame(const std::chrono::milliseconds delay = std::chrono::milliseconds{0}) -> void;
+
+    /**
+        @brief Cap how often this window runs. Frames wanted sooner are delayed, not dropped.
+
+        @param fps Frames per second, 0 removes the cap. VSync still applies to the main window
+    */
+    auto setTargetFrameRate(const uint32_t fps) -> void;
+
+    /**
+        @brief Find when this window next needs to run.
+
+        @param continuous Consider the window as always having something to do
+
+        @return Time the next frame is due or std::nullopt if the window is idle.
+    */
+    auto getNextFrameTime(const bool continuous) -> std::optional<std::chrono::steady_clock::time_point>;
+
+    /**
+        @brief Capture the next rendered frame. Pixels are read back asynchronously, the callback runs at the
+            start of a later run() once the GPU is done with the copy.
+
+        @note Forces the next frame to be redrawn whatever the redraw policy.
+        @note Only one capture is in flight at a time. Requesting another one before the first is delivered
+            replaces the one waiting to start.
+
+        @param onCaptured Called with the frame's pixels
+    */
+    auto captureFrame(CaptureCallback onCaptured) -> void;
+
+    /**
+        @brief Set how much of each frame can be spent on GPU uploads of asynchronously loaded resources.
+
+        @note At least one pending upload runs each frame regardless.
+
+        @param budget Time allowed per frame
+    */
+    auto setUploadBudget(const std::chrono::microseconds budget) -> void;
+
+    /**
+        @brief Find the top most element under a point, same as the hover resolution does.
+
+        @param point Point in window coordinates
+
+        @return Id of the element or NOTHING if no element is there.
+    */
+    auto hitTest(const glm::ivec2& point) -> uint32_t;
+    auto getHitGridStats() const -> const core::HitGrid::Stats&;
+    auto getInputStats() const -> const InputStats&;
+
+    /** @brief Rolling stats of the last rendered frames. Skipped frames don't contribute. */
+    auto getFrameStats() const -> const core::FrameStats&;
+
+    /**
+        @brief Periodically append a snapshot of the frame stats to a file, one JSON object per line.
+
+        @param filePath File to append to. Empty path disables snapshots
+        @param period Time between two snapshots
+    */
+    auto setStatsSnapshotFile(const std::filesystem::path& filePath,
+        const std::chrono::milliseconds period = std::chrono::milliseconds{1000}) -> void;
 
     /* Mandatory typeinfo */
     INSERT_TYPEINFO(UIWindow);
@@ -41,6 +192,8 @@ private:
     auto render(const glm::mat4& projection) -> void override;
     auto layout() -> void override;
     auto event(UIStatePtr& state) -> void override;
+    auto queueInput(const PendingInput::Type type, const glm::ivec4& args) -> void;
+    auto dispatchQueuedInput() -> void;
     auto windowResizeHook(const uint32_t newX, const uint32_t newY) -> void;
     auto windowMouseEnterHook(const bool entered) -> void;
     auto keyHook(const uint32_t key, const uint32_t scancode, const uint32_t action,
@@ -51,26 +204,69 @@ private:
     auto propagateEventTo(const core::IEvent& event, const std::optional<uint32_t> nodeId) -> void;
     auto updateWindowSizeAndProjection(const glm::ivec2 newSize) -> void;
     auto initializeDefaultCursors() -> void;
-    auto areRenderPreconditionsSatisfied(const UIBasePtr& node) -> bool;
-    auto areLayoutPreconditionsSatisfied(const UIBasePtr& node) -> bool;
-    auto preRenderSetup(const UIBasePtr& node, const glm::mat4& projection) -> void;
-    auto preLayoutSetup(const UIBasePtr& node) -> void;
+    auto areRenderPreconditionsSatisfied(UIBase* node) -> bool;
+    auto areLayoutPreconditionsSatisfied(UIBase* node) -> bool;
+    auto needsLayoutVisit(UIBase* node) -> bool;
+    auto layoutPass() -> void;
+    auto renderPass(const glm::ivec4& drawArea) -> uint32_t;
+    auto renderFrame() -> void;
+    auto deliverCapture() -> void;
+    auto collectGpuTimers() -> void;
+    auto writeStatsSnapshot() -> void;
+    auto hasPendingFrameWork() -> bool;
+    auto syncFlatNodes() -> void;
+    auto flattenSubtree(UIBase* node, bool isReachable) -> void;
+    auto getBroadcastRecipients(const uint32_t eventId) -> const std::vector<uint32_t>&;
+    auto resyncFlatNodes(const UIBase* node, uint32_t& index) -> bool;
+    auto preLayoutSetup(UIBase* node) -> void;
     auto propagateHoverScanEvent() -> void;
-    auto postRenderActions(const UIBasePtr& node) -> void;
-    auto postLayoutActions(const UIBasePtr& node) -> void;
+    auto rebuildHitGrid() -> void;
+    auto postRenderActions(UIBase* node) -> void;
+    auto postLayoutActions(UIBase* node) -> void;
 
 private:
     core::WindowBinder::InputCallbacks cbs_;
     core::WindowHandle window_;
     glm::mat4 projection_;
     std::string title_;
-    std::queue<UIBasePtr> processingQueue_;
+    std::vector<FlatNode> flatNodes_;
+    uint64_t flatNodesVersion_{0};
+    std::unordered_map<uint32_t, uint32_t> nodeIndexById_;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> broadcastRecipients_;
+    uint64_t recipientsListenersVersion_{0};
+    core::HitGrid hitGrid_;
+    uint64_t hitGridVersion_{0};
+    bool isHitGridDirty_{true};
     UIStatePtr uiState_{utils::make<UIState>()};
     bool forcedQuit_{false};
     bool isMainWindow_{false};
-    glm::ivec2 mouseMovedTo_{0,0};
-    bool needsMoveUpdate_{false};
+    std::vector<PendingInput> pendingInputs_;
+    std::vector<PendingInput> dispatchingInputs_;
+    InputStats inputStats_;
+    LayoutStats layoutStats_;
+    RedrawPolicy redrawPolicy_{RedrawPolicy::ALWAYS};
+    core::GPUBinder::Framebuffer framebuffer_;
+    glm::ivec4 damage_{0};
+    bool isFullyDamaged_{true};
+    uint64_t skippedFramesCount_{0};
+    uint64_t renderedFramesCount_{0};
+    core::GPUBinder::Readback readback_;
+    CaptureCallback pendingCapture_;
+    CaptureCallback inFlightCapture_;
+    uint64_t inFlightFrame_{0};
+    std::chrono::microseconds uploadBudget_{2000};
+    core::FrameStats frameStats_;
+    std::array<GpuTimer, 4> gpuTimers_;
+    uint32_t nextGpuTimer_{0};
+    std::filesystem::path statsSnapshotPath_;
+    std::chrono::milliseconds statsSnapshotPeriod_{1000};
+    std::chrono::steady_clock::time_point lastStatsSnapshot_;
+    std::chrono::steady_clock::time_point lastFrameTime_;
+    std::chrono::steady_clock::duration minFrameInterval_{0};
+    std::atomic<int64_t> requestedFrameNs_{NO_FRAME_REQUEST}; /* Steady clock, since its epoch */
 
+    static constexpr uint64_t MAX_GPU_FRAME_TIME_NS{10'000'000'000};
+    static constexpr int64_t NO_FRAME_REQUEST{std::numeric_limits<int64_t>::max()};
     static int32_t MAX_LAYERS;
     static bool isFirstWindow_;
 };
@@ -2,7 +2,9 @@
 
 #include <print>
 #include <memory>
+#include <ostream>
 #include <random>
+#include <string_view>
 
 #include "vendor/glm/glm.hpp"
 
@@ -264,5 +266,110 @@ inline auto clamp(const glm::vec2& vec, const glm::vec2& min, const glm::vec2& m
     return {std::clamp(vec.x, min.x, max.x), std::clamp(vec.y, min.y, max.y)};
 }
 
+/**
+    @brief Compute the union of two rectangles. Empty rectangles are ignored.
+
+    @param a First rectangle (x, y, width, height)
+    @param b Second rectangle (x, y, width, height)
+
+    @return Smallest rectangle containing both.
+*/
+inline auto rectUnion(const glm::ivec4& a, const glm::ivec4& b) -> glm::ivec4
+{
+    if (a.z <= 0 || a.w <= 0) { return b; }
+    if (b.z <= 0 || b.w <= 0) { return a; }
+
+    const glm::ivec2 start{std::min(a.x, b.x), std::min(a.y, b.y)};
+    const glm::ivec2 end{std::max(a.x + a.z, b.x + b.z), std::max(a.y + a.w, b.y + b.w)};
+    return {start, end - start};
+}
+
+/**
+    @brief Compute the intersection of two rectangles.
+
+    @param a First rectangle (x, y, width, height)
+    @param b Second rectangle (x, y, width, height)
+
+    @return Overlapping area. Width/height are zero if there's no overlap.
+*/
+inline auto rectIntersection(const glm::ivec4& a, const glm::ivec4& b) -> glm::ivec4
+{
+    const glm::ivec2 start{std::max(a.x, b.x), std::max(a.y, b.y)};
+    const glm::ivec2 end{std::min(a.x + a.z, b.x + b.z), std::min(a.y + a.w, b.y + b.w)};
+    return {start, std::max(0, end.x - start.x), std::max(0, end.y - start.y)};
+}
+
+/**
+    @brief Decode the UTF-8 codepoint starting at `pos` and advance `pos` past it.
+
+    @note Malformed or truncated sequences decode to U+FFFD and advance by a single byte.
+
+    @param text UTF-8 encoded text
+    @param pos Byte offset to decode from. Gets moved to the start of the next codepoint
+
+    @return Decoded codepoint.
+*/
+inline auto nextCodepoint(const std::string_view text, std::size_t& pos) -> uint32_t
+{
+    static constexpr uint32_t REPLACEMENT_CHAR{0xFFFD};
+
+    const uint8_t lead = text[pos];
+    const uint32_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+    if (!length || pos + length > text.size())
+    {
+        ++pos;
+        return REPLACEMENT_CHAR;
+    }
+
+    uint32_t codepoint = length == 1 ? lead : lead & (0xFF >> (length + 1));
+    for (uint32_t i = 1; i < length; ++i)
+    {
+        const uint8_t cont = text[pos + i];
+        if ((cont & 0xC0) != 0x80)
+        {
+            ++pos;
+            return REPLACEMENT_CHAR;
+        }
+        codepoint = (codepoint << 6) | (cont & 0x3F);
+    }
+
+    pos += length;
+    return codepoint;
+}
+
+/**
+    @brief Transparent string hasher. Allows unordered containers keyed by std::string to be searched
+        with std::string_view/const char* without constructing a temporary std::string.
+*/
+struct StringHash
+{
+    using is_transparent = void;
+
+    auto operator()(const std::string_view str) const -> std::size_t
+    {
+        return std::hash<std::string_view>{}(str);
+    }
+};
+
+/**
+    @brief Write a string as a quoted JSON string, escaping what JSON doesn't allow raw.
+
+    @param out Stream to write to
+    @param str String to write. Bytes above 0x7F are passed through, UTF-8 stays valid
+*/
+inline auto writeJsonString(std::ostream& out, const std::string_view str) -> void
+{
+    static constexpr char hexDigits[] = "0123456789abcdef";
+    out << '"';
+    for (const char c : str)
+    {
+        const uint8_t byte = static_cast<uint8_t>(c);
+        if (c == '"' || c == '\\') { out << '\\' << c; }
+        else if (byte < 0x20) { out << "\\u00" << hexDigits[byte >> 4] << hexDigits[byte & 0xF]; }
+        else { out << c; }
+    }
+    out << '"';
+}
+
 } // namespace lav::utils
 
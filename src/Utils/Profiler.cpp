@@ -0,0 +1,150 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+#include "src/Utils/Misc.hpp"
+
+namespace lav::utils
+{
+Profiler::ScopedZone::ScopedZone(const char* name, const std::string_view tag, const uint32_t id)
+{
+    if (!Profiler::get().isEnabled()) { return; }
+
+    zone_.name = name;
+    zone_.id = id;
+    std::copy_n(tag.data(), std::min(tag.size(), sizeof(zone_.tag) - 1), zone_.tag);
+    zone_.startNs = now();
+}
+
+Profiler::ScopedZone::~ScopedZone()
+{
+    /* Profiling was disabled when the zone started, there's no start to measure from. */
+    if (!zone_.name) { return; }
+
+    zone_.durationNs = now() - zone_.startNs;
+    Profiler::get().record(zone_);
+}
+
+auto Profiler::get() -> Profiler&
+{
+    static Profiler instance;
+    return instance;
+}
+
+auto Profiler::record(const Zone& zone) -> void
+{
+    ThreadRing& ring = getThreadRing();
+
+    /* Only this thread writes the ring. The slot's stamp tells a concurrent dump whether what it copied is
+        whole: cleared before the write, set to the new index after. */
+    const uint64_t index = ring.written.load(std::memory_order_relaxed);
+    Slot& slot = ring.slots[index % RING_CAPACITY];
+    slot.stamp.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.zone = zone;
+    slot.stamp.store(index + 1, std::memory_order_release);
+    ring.written.store(index + 1, std::memory_order_release);
+}
+
+auto Profiler::dumpChromeTrace(const std::filesystem::path& outPath) -> std::optional<uint64_t>
+{
+    std::ofstream out{outPath, std::ios::trunc};
+    if (!out.is_open())
+    {
+        log_.error("Couldn't open '{}' for writing the trace", outPath.string());
+        return std::nullopt;
+    }
+
+    std::scoped_lock lock{ringsMutex_};
+    uint64_t zonesWritten{0};
+    std::vector<Zone> zones;
+    zones.reserve(RING_CAPACITY);
+
+    /* Chrome wants microseconds. Three decimals keep the nanoseconds. */
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (const auto& ring : rings_)
+    {
+        /* The owner thread keeps going. A zone is only kept if its slot held it before and after the copy. */
+        const uint64_t end = ring->written.load(std::memory_order_acquire);
+        const uint64_t begin = end > RING_CAPACITY ? end - RING_CAPACITY : 0;
+        zones.clear();
+        for (uint64_t i = begin; i < end; ++i)
+        {
+            const Slot& slot = ring->slots[i % RING_CAPACITY];
+            if (slot.stamp.load(std::memory_order_acquire) != i + 1) { continue; }
+
+            const Zone zone = slot.zone;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.stamp.load(std::memory_order_relaxed) != i + 1) { continue; }
+
+            zones.emplace_back(zone);
+        }
+
+        if (ring != rings_.front()) { out << ','; }
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->threadId
+            << ",\"args\":{\"name\":";
+        writeJsonString(out, ring->threadName.empty() ? "thread " + std::to_string(ring->threadId) : ring->threadName);
+        out << "}}";
+
+        for (const Zone& zone : zones)
+        {
+            out << ",{\"name\":";
+            writeJsonString(out, zone.name);
+            out << ",\"cat\":\"lav\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->threadId
+                << ",\"ts\":" << zone.startNs / 1000.0 << ",\"dur\":" << zone.durationNs / 1000.0;
+            if (zone.tag[0] || zone.id)
+            {
+                out << ",\"args\":{\"type\":";
+                writeJsonString(out, zone.tag);
+                out << ",\"id\":" << zone.id << '}';
+            }
+            out << '}';
+        }
+        zonesWritten += zones.size();
+    }
+    out << "]}\n";
+
+    if (!out)
+    {
+        log_.error("Couldn't write the trace to '{}'", outPath.string());
+        return std::nullopt;
+    }
+
+    log_.info("Wrote {} zones from {} threads to '{}'", zonesWritten, rings_.size(), outPath.string());
+    return zonesWritten;
+}
+
+auto Profiler::setThreadName(const std::string& name) -> void
+{
+    ThreadRing& ring = getThreadRing();
+    std::scoped_lock lock{ringsMutex_};
+    ring.threadName = name;
+}
+
+auto Profiler::setEnabled(const bool enabled) -> void { isEnabled_.store(enabled, std::memory_order_relaxed); }
+
+auto Profiler::isEnabled() const -> bool { return isEnabled_.load(std::memory_order_relaxed); }
+
+auto Profiler::now() -> int64_t
+{
+    /* Same clock for every thread so zones line up in the trace. */
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+auto Profiler::getThreadRing() -> ThreadRing&
+{
+    /* Lock is only taken the first time a thread records. */
+    thread_local ThreadRing* ring{nullptr};
+    if (ring) { return *ring; }
+
+    std::scoped_lock lock{ringsMutex_};
+    ring = rings_.emplace_back(std::make_unique<ThreadRing>()).get();
+    ring->threadId = rings_.size();
+    return *ring;
+}
+} // namespace lav::utils
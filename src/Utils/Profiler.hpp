@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "src/Utils/Logger.hpp"
+
+namespace lav::utils
+{
+/**
+    @brief Records timed zones of code into per thread ring buffers and dumps them as Chrome trace_event JSON
+        (chrome://tracing, ui.perfetto.dev).
+
+    @note 1. Each thread only ever writes to its own ring so recording takes no locks. Rings keep the last
+        RING_CAPACITY zones per thread, older ones get overwritten.
+    @note 2. Use the LAV_PROFILE_* macros instead of the class directly. Those compile to nothing unless
+        LAV_PROFILING is defined.
+*/
+class Profiler
+{
+public:
+    struct Zone
+    {
+        const char* name{nullptr};  /* Must outlive the profiler, string literals only */
+        char tag[24]{};             /* Optional detail, i.e the node type. Copied, may be truncated */
+        uint32_t id{0};             /* Optional detail, i.e the node id. 0 means none */
+        int64_t startNs{0};
+        int64_t durationNs{0};
+    };
+
+    /** @brief Times the scope it lives in. */
+    class ScopedZone
+    {
+    public:
+        ScopedZone(const char* name, const std::string_view tag = {}, const uint32_t id = 0);
+        ~ScopedZone();
+        ScopedZone(const ScopedZone&) = delete;
+        ScopedZone(ScopedZone&&) = delete;
+        ScopedZone& operator=(const ScopedZone&) = delete;
+        ScopedZone& operator=(ScopedZone&&) = delete;
+
+    private:
+        Zone zone_;
+    };
+
+    static constexpr uint32_t RING_CAPACITY{1u << 15};
+
+public:
+    static auto get() -> Profiler&;
+
+    /**
+        @brief Record a finished zone into the calling thread's ring.
+
+        @param zone Zone to record, times as returned by now()
+    */
+    auto record(const Zone& zone) -> void;
+
+    /**
+        @brief Write everything currently in the rings as Chrome trace_event JSON.
+
+        @note Safe to call while other threads keep recording. Zones overwritten during the dump are left out.
+
+        @param outPath File to write
+
+        @return Number of zones written or std::nullopt if the file couldn't be written.
+    */
+    auto dumpChromeTrace(const std::filesystem::path& outPath) -> std::optional<uint64_t>;
+
+    /** @brief Name the calling thread in dumped traces. */
+    auto setThreadName(const std::string& name) -> void;
+
+    /** @brief Start or stop recording. Starts stopped. Disabled zones don't even read the clock. */
+    auto setEnabled(const bool enabled) -> void;
+    auto isEnabled() const -> bool;
+
+    static auto now() -> int64_t;
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> stamp{0}; /* Index of the zone held + 1, 0 while being written */
+        Zone zone;
+    };
+
+    struct ThreadRing
+    {
+        std::array<Slot, RING_CAPACITY> slots;
+        std::atomic<uint64_t> written{0};
+        std::string threadName;
+        uint32_t threadId{0};
+    };
+
+    Profiler() = default;
+    ~Profiler() = default;
+    Profiler(const Profiler&) = delete;
+    Profiler(Profiler&&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+    Profiler& operator=(Profiler&&) = delete;
+
+    auto getThreadRing() -> ThreadRing&;
+
+private:
+    utils::Logger log_{"Profiler"};
+    std::atomic<bool> isEnabled_{false};
+    std::mutex ringsMutex_;
+    std::vector<std::unique_ptr<ThreadRing>> rings_; /* Never shrinks, rings outlive their threads */
+};
+} // namespace lav::utils
+
+#ifdef LAV_PROFILING
+#define LAV_PROFILE_CONCAT_INNER(a, b) a##b
+#define LAV_PROFILE_CONCAT(a, b) LAV_PROFILE_CONCAT_INNER(a, b)
+
+/** @brief Time the enclosing scope under a literal name. */
+#define LAV_PROFILE_ZONE(name)\
+    const lav::utils::Profiler::ScopedZone LAV_PROFILE_CONCAT(lavProfileZone, __LINE__){name}
+
+/** @brief Same as LAV_PROFILE_ZONE but also tagged with a type name and an id, i.e of a node. */
+#define LAV_PROFILE_ZONE_TAGGED(name, tag, id)\
+    const lav::utils::Profiler::ScopedZone LAV_PROFILE_CONCAT(lavProfileZone, __LINE__){name, tag, id}
+#else
+#define LAV_PROFILE_ZONE(name)
+#define LAV_PROFILE_ZONE_TAGGED(name, tag, id)
+#endif
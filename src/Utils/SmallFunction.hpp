@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace lav::utils
+{
+template<typename Signature, std::size_t Capacity = 48>
+class SmallFunction;
+
+/**
+    @brief Copyable type erased callable, like std::function, but the callable always lives inside the
+        object itself. Never allocates.
+
+    @note Callables bigger than `Capacity` are rejected at compile time instead of silently going to
+        the heap. Capture less or capture by reference/pointer.
+*/
+template<typename R, typename... Args, std::size_t Capacity>
+class SmallFunction<R(Args...), Capacity>
+{
+public:
+    SmallFunction() = default;
+
+    template<typename F>
+    requires (!std::is_same_v<std::decay_t<F>, SmallFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+    SmallFunction(F&& callable)
+    {
+        using Fn = std::decay_t<F>;
+        static_assert(sizeof(Fn) <= Capacity, "Callable doesn't fit in the inline storage");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "Callable is over aligned");
+        static_assert(std::is_copy_constructible_v<Fn>, "Callable needs to be copyable");
+
+        ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(callable));
+        ops_ = &opsFor<Fn>;
+    }
+
+    SmallFunction(const SmallFunction& other) { copyFrom(other); }
+
+    SmallFunction(SmallFunction&& other) noexcept { moveFrom(other); }
+
+    ~SmallFunction() { reset(); }
+
+    auto operator=(const SmallFunction& other) -> SmallFunction&
+    {
+        if (this != &other)
+        {
+            reset();
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    auto operator=(SmallFunction&& other) noexcept -> SmallFunction&
+    {
+        if (this != &other)
+        {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    auto operator()(Args... args) const -> R
+    {
+        return ops_->invoke(storage_, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const { return ops_ != nullptr; }
+
+    auto reset() -> void
+    {
+        if (!ops_) { return; }
+        ops_->destroy(storage_);
+        ops_ = nullptr;
+    }
+
+private:
+    struct Ops
+    {
+        R (*invoke)(void*, Args&&...);
+        void (*copy)(void*, const void*);
+        void (*move)(void*, void*);
+        void (*destroy)(void*);
+    };
+
+    template<typename Fn>
+    static constexpr Ops opsFor{
+        .invoke = [](void* self, Args&&... args) -> R
+            { return (*static_cast<Fn*>(self))(std::forward<Args>(args)...); },
+        .copy = [](void* dst, const void* src)
+            { ::new (dst) Fn(*static_cast<const Fn*>(src)); },
+        .move = [](void* dst, void* src)
+            { ::new (dst) Fn(std::move(*static_cast<Fn*>(src))); static_cast<Fn*>(src)->~Fn(); },
+        .destroy = [](void* self)
+            { static_cast<Fn*>(self)->~Fn(); }
+    };
+
+    auto copyFrom(const SmallFunction& other) -> void
+    {
+        if (!other.ops_) { return; }
+        other.ops_->copy(storage_, other.storage_);
+        ops_ = other.ops_;
+    }
+
+    auto moveFrom(SmallFunction& other) -> void
+    {
+        if (!other.ops_) { return; }
+        other.ops_->move(storage_, other.storage_);
+        ops_ = std::exchange(other.ops_, nullptr);
+    }
+
+private:
+    alignas(std::max_align_t) mutable std::byte storage_[Capacity];
+    const Ops* ops_{nullptr};
+};
+} // namespace lav::utils